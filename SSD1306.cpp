@@ -1,17 +1,88 @@
+#include <cassert>
 #include <cstring>
 #include <Arduino.h>
 #include "SSD1306.h"
+#include "SSD1306_Bitmap.h"
+#include "SSD1306_Raster.h"
 #include <SPI.h>
 
+#if defined(SSD1306_FAST_GPIO) && defined(ARDUINO_ARCH_ESP32)
+#include "soc/gpio_reg.h"
+#endif
+
+
+// Bit mask of the rows of `page` that lie in [y0, y1)
+static uint8_t clipRows(int16_t page, int16_t y0, int16_t y1) {
+  int16_t top = page * 8;
+
+  if (y1 <= top || y0 >= top + 8) return 0;
+
+  uint8_t mask = 0xFF;
+  if (y0 > top) mask &= 0xFF << (y0 - top);
+  if (y1 < top + 8) mask &= 0xFF >> (top + 8 - y1);
+  return mask;
+}
 
-#ifndef swap16
-#define swap16(a, b) \
-  { \
-    int16_t t = a; \
-    a = b; \
-    b = t; \
+// Apply raster operation `Op` to the bits of *p selected by `mask`
+template <uint8_t Op>
+static inline void rasterOp(uint8_t* p, uint8_t mask) {
+  switch (Op) {
+    case SSD1306_ROP_SET: *p |= mask; break;
+    case SSD1306_ROP_CLEAR: *p &= ~mask; break;
+    case SSD1306_ROP_INVERSE: *p ^= mask; break;
+  }
+}
+
+const uint8_t SSD1306_PATTERN_CHECKER[8] = { 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA };
+const uint8_t SSD1306_PATTERN_DOTS[8] = { 0x11, 0x00, 0x44, 0x00, 0x11, 0x00, 0x44, 0x00 };
+const uint8_t SSD1306_PATTERN_HATCH_DOWN[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+const uint8_t SSD1306_PATTERN_HATCH_UP[8] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+const uint8_t SSD1306_PATTERN_GRID[8] = { 0xFF, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01 };
+
+static const uint8_t solidPattern[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+// Run `call` with `dst` bound to the SSD1306_RopTarget that matches `color`, so
+// the raster operation is picked once per primitive instead of once per pixel.
+// PIXEL_OP is for composites made of pixels only, LINE_OP for lines and fills only.
+#define SSD1306_WITH_PIXEL_OP(color, call) \
+  if (pixelOp(color) == SSD1306_ROP_SET) { \
+    SSD1306_RopTarget<SSD1306_ROP_SET> dst(*this); \
+    call; \
+  } else { \
+    SSD1306_RopTarget<SSD1306_ROP_CLEAR> dst(*this); \
+    call; \
+  }
+
+#define SSD1306_WITH_LINE_OP(color, call) \
+  switch (color) { \
+    case SSD1306_WHITE: { SSD1306_RopTarget<SSD1306_ROP_SET> dst(*this); call; break; } \
+    case SSD1306_BLACK: { SSD1306_RopTarget<SSD1306_ROP_CLEAR> dst(*this); call; break; } \
+    case SSD1306_INVERSE: { SSD1306_RopTarget<SSD1306_ROP_INVERSE> dst(*this); call; break; } \
+  }
+
+#define SSD1306_WITH_OPS(color, call) \
+  switch (color) { \
+    case SSD1306_WHITE: \
+      if (Inverted) { SSD1306_RopTarget<SSD1306_ROP_CLEAR, SSD1306_ROP_SET> dst(*this); call; } \
+      else { SSD1306_RopTarget<SSD1306_ROP_SET> dst(*this); call; } \
+      break; \
+    case SSD1306_BLACK: \
+      if (Inverted) { SSD1306_RopTarget<SSD1306_ROP_SET, SSD1306_ROP_CLEAR> dst(*this); call; } \
+      else { SSD1306_RopTarget<SSD1306_ROP_CLEAR> dst(*this); call; } \
+      break; \
+    case SSD1306_INVERSE: { \
+      SSD1306_RopTarget<SSD1306_ROP_CLEAR, SSD1306_ROP_INVERSE> dst(*this); \
+      call; \
+      break; \
+    } \
+  }
+
+#define SSD1306_WITH_PATTERN_OP(color, pattern, call) \
+  switch (color) { \
+    case SSD1306_WHITE: { SSD1306_PatternTarget<SSD1306_ROP_SET> dst(*this, pattern); call; break; } \
+    case SSD1306_BLACK: { SSD1306_PatternTarget<SSD1306_ROP_CLEAR> dst(*this, pattern); call; break; } \
+    case SSD1306_INVERSE: { SSD1306_PatternTarget<SSD1306_ROP_INVERSE> dst(*this, pattern); call; break; } \
   }
-#endif
 
 const uint8_t initData[] = {
   SSD1306_SETLOWCOLUMN,
@@ -31,23 +102,71 @@ const uint8_t initData[] = {
   SSD1306_COMSCANINC
 };
 
-SSD1306::SSD1306(int8_t mosi_pin, int8_t sclk_pin, int8_t dc_pin, int8_t rst_pin, int8_t cs_pin) {
+SSD1306::SSD1306(int8_t mosi_pin, int8_t sclk_pin, int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
+                 SPIClass* bus, uint8_t* buffer) {
   mosiPin = mosi_pin;
   clkPin = sclk_pin;
   dcPin = dc_pin;
   rstPin = rst_pin;
   csPin = cs_pin;
-  spi = new SPIClass(HSPI);
+  OwnsBus = (bus == NULL);
+  spi = bus ? bus : new SPIClass(HSPI);
+
+#ifdef SSD1306_NO_DEFAULT_BUFFER
+  assert(buffer != NULL);
+  DefaultBuffer = buffer;
+#else
+  DefaultBuffer = buffer ? buffer : BuiltinBuffer.data;
+#endif
+  SSD1306_Buffer = DefaultBuffer;
+  TextFlags = TEXT_OPAQUE;
+  TextScale = 1;
+  Inverted = 0;
+  Initialized = 0;
+  Rotation = 0;
+  Width = SSD1306_WIDTH;
+  Height = SSD1306_HEIGHT;
+  clearDirty();
+  resetViewport();
+
+  FlushActive = 0;
+  FlushDirtyOnly = 0;
+  FlushPos = 0;
+  FrameSeq = 0;
+  ByteCost = 0;
+
+  HwCs = 0;
+  FastGpio = 1;
+  csSet = csClr = dcSet = dcClr = NULL;
+  csMask = dcMask = 0;
+}
+
+SSD1306::~SSD1306() {
+  if (OwnsBus) delete spi;
 }
 
 void SSD1306::init() {
+  // SSD1306_NO_DEFAULT_BUFFER without a buffer, with NDEBUG the assert above is gone
+  if (!SSD1306_Buffer) return;
 
   pinMode(dcPin, OUTPUT);
   pinMode(rstPin, OUTPUT);
   pinMode(csPin, OUTPUT);
 
+  // Resolve the GPIO registers once, writeCommand/writeData toggle DC/CS through them
+  setFastGpio(FastGpio);
+
   // Initialize SPI
+#if defined(ARDUINO_ARCH_ESP32)
+  if (HwCs) {
+    spi->begin(clkPin, -1, mosiPin, csPin);
+    spi->setHwCs(true);
+  } else {
+    spi->begin(clkPin, -1, mosiPin);
+  }
+#else
   spi->begin(clkPin, -1, mosiPin);
+#endif
   spi->setBitOrder(SPI_MSBFIRST);
   spi->setDataMode(SPI_MODE0);
   spi->setClockDivider(SPI_CLOCK_DIV2);
@@ -61,6 +180,12 @@ void SSD1306::init() {
   for (uint8_t i = 0; i < sizeof(initData); i++)
     writeCommand(initData[i]);
 
+  // initData leaves the panel unrotated, apply 180 degree flip if selected before init()
+  if (Rotation >= 2) {
+    writeCommand(SSD1306_SEGREMAP | 0x01);
+    writeCommand(SSD1306_COMSCANDEC);
+  }
+
   // Clear screen
   clear();
   dim(false);
@@ -77,21 +202,324 @@ void SSD1306::init() {
 }
 
 void SSD1306::display() {
-  uint8_t x = 2;
+  for (uint8_t i = 0; i < (SSD1306_HEIGHT >> 3); i++) {
+    flushPage(i, false);
+  }
+
+  endFrame();
+}
 
+void SSD1306::displayDirty() {
   for (uint8_t i = 0; i < (SSD1306_HEIGHT >> 3); i++) {
-    // Set Position
-    writeCommand(0xB0 | i);                 // go to page Y
-    writeCommand(0x00 | (x & 0xf));         // // lower col addr
-    writeCommand(0x10 | ((x >> 4) & 0xf));  // upper col addr
-                                            // Write Data
-    writeData(&SSD1306_Buffer[SSD1306_WIDTH * i], SSD1306_WIDTH);
+    flushPage(i, true);
+  }
+
+  endFrame();
+}
+
+// Incremental flush: send up to `n` pages (clean pages are skipped for free
+// with dirtyOnly) of the current frame, continuing where the last call stopped.
+// dirtyOnly is latched when a frame starts. Returns true when the frame has
+// fully landed, see frameSequence().
+bool SSD1306::flushPages(uint8_t n, bool dirtyOnly) {
+  if (!FlushActive) startFrame(dirtyOnly);
+
+  while (FlushPos < (SSD1306_HEIGHT >> 3)) {
+    if (FlushDirtyOnly && DirtyMin[FlushPos] > DirtyMax[FlushPos]) {
+      FlushPos++;
+      continue;
+    }
+    if (!n) return false;
+
+    flushPage(FlushPos++, FlushDirtyOnly);
+    n--;
+  }
+
+  endFrame();
+  return true;
+}
+
+// Like flushPages(), but sends as many pages as are estimated to fit in
+// `budget_us` microseconds. The cost per byte is learned from the pages sent.
+bool SSD1306::flushStep(uint32_t budget_us, bool dirtyOnly) {
+  uint32_t start = micros();
+  bool sent = false;
+
+  if (!FlushActive) startFrame(dirtyOnly);
+
+  while (FlushPos < (SSD1306_HEIGHT >> 3)) {
+    uint8_t i = FlushPos;
+    uint16_t bytes = SSD1306_WIDTH;
+
+    if (FlushDirtyOnly) {
+      if (DirtyMin[i] > DirtyMax[i]) {
+        FlushPos++;
+        continue;
+      }
+      bytes = DirtyMax[i] - DirtyMin[i] + 1;
+    }
+
+    // 3 command bytes to address the page. The first page always goes out,
+    // so a budget below one page still makes progress.
+    uint32_t estimate = ((bytes + 3) * ByteCost) >> 8;
+    if (sent && micros() - start + estimate > budget_us) return false;
+
+    uint32_t t0 = micros();
+    flushPage(i, FlushDirtyOnly);
+    FlushPos++;
+    sent = true;
+
+    // Moving average of the cost per byte in 1/256 us
+    uint32_t cost = ((micros() - t0) << 8) / (bytes + 3);
+    ByteCost = ByteCost ? (ByteCost * 3 + cost) >> 2 : cost;
   }
+
+  endFrame();
+  return true;
+}
+
+void SSD1306::startFrame(bool dirtyOnly) {
+  FlushActive = 1;
+  FlushDirtyOnly = dirtyOnly;
+  FlushPos = 0;
+}
+
+// A frame has landed, abandon any incremental flush in progress
+void SSD1306::endFrame() {
+  FlushActive = 0;
+  FlushPos = 0;
+  FrameSeq++;
+}
+
+// Send one page, or just its dirty span, and mark it clean.
+// Returns the number of data bytes sent.
+uint8_t SSD1306::flushPage(uint8_t i, bool dirtyOnly) {
+  uint8_t page[SSD1306_WIDTH];
+  uint8_t x = 0;
+  uint8_t n = SSD1306_WIDTH;
+
+  if (dirtyOnly) {
+    if (DirtyMin[i] > DirtyMax[i]) return 0;
+    x = DirtyMin[i];
+    n = DirtyMax[i] - x + 1;
+  }
+
+  // Set Position
+  setColumn(i, x);
+  // Write Data
+  if (Rotation & 1) {
+    transposePage(SSD1306_Buffer, i, page);
+    writeData(&page[x], n);
+  } else {
+    writeData(&SSD1306_Buffer[SSD1306_WIDTH * i + x], n);
+  }
+
+  DirtyMin[i] = 0xFF;
+  DirtyMax[i] = 0x00;
+  return n;
+}
+
+// Mark a rectangle in viewport coordinates for the next displayDirty()
+void SSD1306::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (!clipToViewport(x, y, w, h)) return;
+
+  // Convert to physical panel coordinates, see transposePage()
+  int16_t px0 = x, px1 = x + w - 1;
+  int16_t py0 = y, py1 = y + h - 1;
+  if (Rotation & 1) {
+    px0 = y;
+    px1 = y + h - 1;
+    py0 = SSD1306_HEIGHT - x - w;
+    py1 = SSD1306_HEIGHT - 1 - x;
+  }
+
+  for (int16_t p = py0 >> 3; p <= (py1 >> 3); p++) {
+    if (px0 < DirtyMin[p]) DirtyMin[p] = px0;
+    if (px1 > DirtyMax[p]) DirtyMax[p] = px1;
+  }
+}
+
+void SSD1306::clearDirty() {
+  memset(DirtyMin, 0xFF, sizeof(DirtyMin));
+  memset(DirtyMax, 0x00, sizeof(DirtyMax));
+}
+
+void SSD1306::setColumn(uint8_t page, uint8_t column) {
+  uint8_t x = column + 2;  // SH1106 RAM is 132 columns wide, the panel starts at column 2
+
+  writeCommand(0xB0 | page);              // go to page Y
+  writeCommand(0x00 | (x & 0xf));         // lower col addr
+  writeCommand(0x10 | ((x >> 4) & 0xf));  // upper col addr
+}
+
+// Build physical page `page` from a portrait buffer as used at 90/270 degrees.
+// Logical pixel (lx, ly) lands on physical (ly, SSD1306_HEIGHT - 1 - lx), so each
+// 8x8 block of the panel is one transposed (and row-reversed) 8x8 block of the buffer.
+void SSD1306::transposePage(const uint8_t* src, uint8_t page, uint8_t* out) {
+  uint8_t block[8];
+
+  for (uint8_t c = 0; c < (SSD1306_WIDTH >> 3); c++) {
+    const uint8_t* in = &src[c * this->Width + this->Width - 8 - 8 * page];
+    for (uint8_t k = 0; k < 8; k++) block[k] = in[7 - k];
+    ssd1306_transpose8(block, &out[c << 3]);
+  }
+}
+
+bool SSD1306::setRotation(uint16_t degrees) {
+  uint8_t rotation;
+
+  if (degrees < 4) rotation = degrees;
+  else if (degrees % 90 == 0 && degrees < 360) rotation = degrees / 90;
+  else return false;
+
+  // Portrait and landscape use a different buffer layout, old content is meaningless
+  if ((rotation ^ this->Rotation) & 1) {
+    clear();
+  }
+
+  this->Rotation = rotation;
+  if (rotation & 1) {
+    this->Width = SSD1306_HEIGHT;
+    this->Height = SSD1306_WIDTH;
+  } else {
+    this->Width = SSD1306_WIDTH;
+    this->Height = SSD1306_HEIGHT;
+  }
+  resetViewport();
+
+  // 180 degrees costs nothing: mirror both segment and COM scan direction
+  if (this->Initialized) {
+    writeCommand(SSD1306_SEGREMAP | (rotation >= 2 ? 0x01 : 0x00));
+    writeCommand(rotation >= 2 ? SSD1306_COMSCANDEC : SSD1306_COMSCANINC);
+  }
+  return true;
+}
+
+// Enter a viewport at (x, y) of the current one: coordinates are translated
+// by (x, y) if `translate` is set, and drawing is clipped to the w x h area
+// intersected with the current clip rectangle
+bool SSD1306::pushViewport(int16_t x, int16_t y, int16_t w, int16_t h, bool translate) {
+  if (ViewDepth >= SSD1306_VIEWPORT_DEPTH) return false;
+
+  ViewStack[ViewDepth++] = View;
+
+  x += View.OriginX;
+  y += View.OriginY;
+  if (translate) {
+    View.OriginX = x;
+    View.OriginY = y;
+  }
+
+  // Intersect, an empty result leaves ClipX0 >= ClipX1 and rejects everything
+  if (x > View.ClipX0) View.ClipX0 = x;
+  if (y > View.ClipY0) View.ClipY0 = y;
+  if (x + w < View.ClipX1) View.ClipX1 = x + w;
+  if (y + h < View.ClipY1) View.ClipY1 = y + h;
+  return true;
+}
+
+void SSD1306::popViewport() {
+  if (ViewDepth) View = ViewStack[--ViewDepth];
+}
+
+void SSD1306::resetViewport() {
+  ViewDepth = 0;
+  View.OriginX = 0;
+  View.OriginY = 0;
+  View.ClipX0 = 0;
+  View.ClipY0 = 0;
+  View.ClipX1 = this->Width;
+  View.ClipY1 = this->Height;
+}
+
+// Translate a rectangle from viewport to buffer coordinates and clip it,
+// returns false if nothing is left
+bool SSD1306::clipToViewport(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+  int16_t x0 = x + View.OriginX;
+  int16_t y0 = y + View.OriginY;
+  int16_t x1 = x0 + w;
+  int16_t y1 = y0 + h;
+
+  if (x0 < View.ClipX0) x0 = View.ClipX0;
+  if (y0 < View.ClipY0) y0 = View.ClipY0;
+  if (x1 > View.ClipX1) x1 = View.ClipX1;
+  if (y1 > View.ClipY1) y1 = View.ClipY1;
+  if (x0 >= x1 || y0 >= y1) return false;
+
+  x = x0;
+  y = y0;
+  w = x1 - x0;
+  h = y1 - y0;
+  return true;
+}
+
+// Whole-primitive rejection: true if the box lies completely outside the clip rectangle
+bool SSD1306::outsideClip(int16_t x, int16_t y, int16_t w, int16_t h) const {
+  x += View.OriginX;
+  y += View.OriginY;
+  return x >= View.ClipX1 || y >= View.ClipY1 || x + w <= View.ClipX0 || y + h <= View.ClipY0;
+}
+
+// Bounding box rejection for lines (pass the last point twice) and triangles
+bool SSD1306::triangleOutsideClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2) const {
+  int16_t xmin = x0, xmax = x0, ymin = y0, ymax = y0;
+
+  if (x1 < xmin) xmin = x1;
+  if (x1 > xmax) xmax = x1;
+  if (x2 < xmin) xmin = x2;
+  if (x2 > xmax) xmax = x2;
+  if (y1 < ymin) ymin = y1;
+  if (y1 > ymax) ymax = y1;
+  if (y2 < ymin) ymin = y2;
+  if (y2 > ymax) ymax = y2;
+
+  return outsideClip(xmin, ymin, xmax - xmin + 1, ymax - ymin + 1);
+}
+
+uint8_t* SSD1306::setBuffer(uint8_t* buffer, bool show) {
+  uint8_t* previous = SSD1306_Buffer;
+
+  SSD1306_Buffer = buffer ? buffer : DefaultBuffer;
+  if (show && SSD1306_Buffer != previous) {
+    // Everything on the panel is stale now, restart any partial flush
+    markAllDirty();
+  }
+
+  return previous;
+}
+
+void SSD1306::loadBuffer(const uint8_t* frame) {
+  memcpy(SSD1306_Buffer, frame, SSD1306_BUFFER_SIZE);
+  markAllDirty();
+}
+
+void SSD1306::displayBuffer(const uint8_t* frame) {
+  uint8_t page[SSD1306_WIDTH];
+
+  for (uint8_t i = 0; i < (SSD1306_HEIGHT >> 3); i++) {
+    setColumn(i, 0);
+    if (Rotation & 1) {
+      transposePage(frame, i, page);
+      writeData(page, SSD1306_WIDTH);
+    } else {
+      writeData(&frame[SSD1306_WIDTH * i], SSD1306_WIDTH);
+    }
+  }
+
+  // The panel no longer shows the framebuffer
+  markAllDirty();
+  endFrame();
+}
+
+void SSD1306::markAllDirty() {
+  memset(DirtyMin, 0x00, sizeof(DirtyMin));
+  memset(DirtyMax, SSD1306_WIDTH - 1, sizeof(DirtyMax));
+  FlushActive = 0;
 }
 
 void SSD1306::clear(SSD1306_COLOR color) {
   uint8_t c = (color == SSD1306_BLACK) ? 0x00 : 0xFF;
-  memset(SSD1306_Buffer, c, sizeof(SSD1306_Buffer));
+  memset(SSD1306_Buffer, c, SSD1306_BUFFER_SIZE);
 }
 
 void SSD1306::reset() {
@@ -126,26 +554,193 @@ void SSD1306::dim(bool dim) {
   writeCommand(contrast);
 }
 
+void SSD1306::setFastGpio(bool enable) {
+  this->FastGpio = enable;
+
+  if (enable) {
+    cachePin(csPin, &csSet, &csClr, &csMask);
+    cachePin(dcPin, &dcSet, &dcClr, &dcMask);
+  } else {
+    csSet = csClr = dcSet = dcClr = NULL;
+  }
+}
+
+void SSD1306::cachePin(int8_t pin, volatile uint32_t** set, volatile uint32_t** clr, uint32_t* mask) {
+  *set = NULL;
+  *clr = NULL;
+  *mask = 0;
+
+#if defined(SSD1306_FAST_GPIO) && defined(ARDUINO_ARCH_ESP32)
+  if (pin >= 0 && pin < 32) {
+    *set = (volatile uint32_t*)GPIO_OUT_W1TS_REG;
+    *clr = (volatile uint32_t*)GPIO_OUT_W1TC_REG;
+    *mask = 1UL << pin;
+  }
+#ifdef GPIO_OUT1_W1TS_REG
+  else if (pin >= 32) {
+    *set = (volatile uint32_t*)GPIO_OUT1_W1TS_REG;
+    *clr = (volatile uint32_t*)GPIO_OUT1_W1TC_REG;
+    *mask = 1UL << (pin - 32);
+  }
+#endif
+#elif defined(SSD1306_FAST_GPIO) && defined(ARDUINO_ARCH_ESP8266)
+  // GPIO16 lives in the RTC block and has no set/clear registers
+  if (pin >= 0 && pin < 16) {
+    *set = &GPOS;
+    *clr = &GPOC;
+    *mask = 1UL << pin;
+  }
+#else
+  (void)pin;
+#endif
+}
+
+inline void SSD1306::select() {
+  if (HwCs) return;
+  if (csClr) *csClr = csMask;
+  else digitalWrite(csPin, LOW);
+}
+
+inline void SSD1306::deselect() {
+  if (HwCs) return;
+  if (csSet) *csSet = csMask;
+  else digitalWrite(csPin, HIGH);
+}
+
+inline void SSD1306::commandMode() {
+  if (dcClr) *dcClr = dcMask;
+  else digitalWrite(dcPin, LOW);
+}
+
+inline void SSD1306::dataMode() {
+  if (dcSet) *dcSet = dcMask;
+  else digitalWrite(dcPin, HIGH);
+}
+
 void SSD1306::writeCommand(uint8_t data) {
-  digitalWrite(csPin, LOW);  // select OLED
-  digitalWrite(dcPin, LOW);  // command
+  select();       // select OLED
+  commandMode();  // command
   (void)spi->transfer(data);
-  digitalWrite(csPin, HIGH);  // un-select OLED
+  deselect();  // un-select OLED
 }
 
-void SSD1306::writeData(uint8_t* buffer, size_t buff_size) {
-  uint8_t* ptr = buffer;
-  digitalWrite(csPin, LOW);   // select OLED
-  digitalWrite(dcPin, HIGH);  // data
+void SSD1306::writeData(const uint8_t* buffer, size_t buff_size) {
+  select();    // select OLED
+  dataMode();  // data
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+  spi->writeBytes(buffer, buff_size);
+#else
+  const uint8_t* ptr = buffer;
   while (buff_size--) (void)spi->transfer(*ptr++);
-  digitalWrite(csPin, HIGH);  // un-select OLED
+#endif
+  deselect();  // un-select OLED
 }
 
-void SSD1306::setCursor(uint8_t x, uint8_t y) {
+void SSD1306::setCursor(int16_t x, int16_t y) {
   this->CurrentX = x;
   this->CurrentY = y;
 }
 
+void SSD1306::setTextStyle(uint8_t style, uint8_t scale) {
+  this->TextFlags = style;
+  this->TextScale = (scale < 1) ? 1 : (scale > 4) ? 4 : scale;
+}
+
+// Each nibble of a glyph column byte stretched to `scale` times as many bits,
+// so a source byte becomes `scale` page bytes with two lookups
+static const uint16_t expandNibble[3][16] = {
+  { 0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF },
+  { 0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF,
+    0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF },
+  { 0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+    0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF }
+};
+
+static inline uint32_t expandByte(uint8_t b, uint8_t scale) {
+  if (scale == 1) return b;
+
+  const uint16_t* t = expandNibble[scale - 2];
+  return t[b & 0x0F] | ((uint32_t)t[b >> 4] << (scale * 4));
+}
+
+// Draw the glyph at the cursor in the current text style straight into the
+// page bytes. The font rows are turned into columns with 8x8 transposes, then
+// each output byte (8 rows of one column) is written with one set and one
+// clear mask, at most two page bytes per column and band.
+void SSD1306::blitGlyph(const FontDef& Font, uint8_t code, SSD1306_COLOR color) {
+  uint32_t cols[16];
+  uint8_t in[8], out[8];
+  const uint16_t* rows = &Font.data[(code - 32) * Font.FontHeight];
+  uint8_t w = Font.FontWidth;
+  uint8_t h = Font.FontHeight;
+  uint8_t scale = TextScale;
+
+  // Column bits of the glyph, LSB is the top row
+  memset(cols, 0, sizeof(cols));
+  for (uint8_t band = 0; band < h; band += 8) {
+    for (uint8_t half = 0; half < w; half += 8) {
+      for (uint8_t k = 0; k < 8; k++) {
+        in[k] = (band + k < h) ? (uint8_t)(rows[band + k] >> (8 - half)) : 0;
+      }
+      ssd1306_transpose8(in, out);
+      // MSB is the leftmost pixel, so column j comes from bit 7 - j
+      for (uint8_t j = 0; j < 8 && half + j < w; j++) {
+        cols[half + j] |= (uint32_t)out[7 - j] << band;
+      }
+    }
+  }
+
+  if (TextFlags & TEXT_BOLD) {
+    for (uint8_t j = w - 1; j > 0; j--) cols[j] |= cols[j - 1];
+  }
+
+  // Set and background pixels follow drawPixel(): each either sets or clears
+  uint8_t fgSet = (pixelOp(color) == SSD1306_ROP_SET) ? 0xFF : 0x00;
+  uint8_t bgSet = (pixelOp((SSD1306_COLOR)!color) == SSD1306_ROP_SET) ? 0xFF : 0x00;
+  uint8_t opaque = (TextFlags & TEXT_TRANSPARENT) ? 0x00 : 0xFF;
+
+  int16_t x0 = this->CurrentX + View.OriginX;
+  int16_t y0 = this->CurrentY + View.OriginY;
+  int16_t cellH = h * scale;
+
+  // Visible columns of the cell
+  int16_t c0 = (x0 < View.ClipX0) ? View.ClipX0 - x0 : 0;
+  int16_t c1 = (x0 + w * scale > View.ClipX1) ? View.ClipX1 - x0 : w * scale;
+
+  // Every 8 source rows make `scale` output bytes per column
+  for (int16_t r = 0; r < cellH; r += 8) {
+    uint8_t band = (r / scale) & ~7;
+    uint8_t part = (r - band * scale) >> 3;
+    uint8_t cover = (cellH - r >= 8) ? 0xFF : (0xFF >> (8 - (cellH - r)));
+
+    int16_t y = y0 + r;
+    uint8_t shift = y & 7;
+    int16_t page = (y - shift) / 8;
+    uint8_t loMask = clipRows(page, View.ClipY0, View.ClipY1);
+    uint8_t hiMask = shift ? clipRows(page + 1, View.ClipY0, View.ClipY1) : 0;
+    if (!loMask && !hiMask) continue;
+
+    int16_t lo = page * this->Width + x0;
+    int16_t hi = lo + this->Width;
+
+    for (int16_t c = c0; c < c1; c++) {
+      uint8_t fg = (uint8_t)(expandByte((uint8_t)(cols[c / scale] >> band), scale) >> (part * 8)) & cover;
+      uint8_t bg = ~fg & cover & opaque;
+      uint16_t set = (uint16_t)((fg & fgSet) | (bg & bgSet)) << shift;
+      uint16_t clr = (uint16_t)((fg & ~fgSet) | (bg & ~bgSet)) << shift;
+
+      if (loMask) {
+        uint8_t* p = &SSD1306_Buffer[lo + c];
+        *p = (*p | ((uint8_t)set & loMask)) & ~((uint8_t)clr & loMask);
+      }
+      if (hiMask) {
+        uint8_t* p = &SSD1306_Buffer[hi + c];
+        *p = (*p | ((uint8_t)(set >> 8) & hiMask)) & ~((uint8_t)(clr >> 8) & hiMask);
+      }
+    }
+  }
+}
+
 char SSD1306::writeString(const char* str, FontDef Font, SSD1306_COLOR color) {
   while (*str) {  // Write until null-byte
     if (writeChar(*str, Font, color) != *str) {
@@ -160,115 +755,141 @@ char SSD1306::writeString(const char* str, FontDef Font, SSD1306_COLOR color) {
 }
 
 char SSD1306::writeChar(char ch, FontDef Font, SSD1306_COLOR color) {
-  uint32_t i, b, j;
-  char c = ch;
   // Check if character is valid
-  if (ch < 32) return 0;
-  if (ch > 126) {
-    if (Font.FontHeight != 10 && Font.FontWidth != 7) return 0;
-
-    switch ((uint8_t)ch) {
-      case 199: ch = 127; break;
-      case 208: ch = 128; break;
-      case 214: ch = 129; break;
-      case 218: ch = 130; break;
-      case 220: ch = 131; break;
-      case 222: ch = 132; break;
-      case 231: ch = 133; break;
-
-      case 240: ch = 134; break;
-      case 243: ch = 135; break;
-      case 246: ch = 136; break;
-      case 250: ch = 137; break;
-      case 252: ch = 138; break;
-      case 253: ch = 139; break;
-      case 254: ch = 140; break;
-    }
-  }
+  uint8_t code = SSD1306_Raster::glyphCode(ch, Font);
+  if (!code) return 0;
+
+  int16_t cellW = Font.FontWidth * TextScale;
+  int16_t cellH = Font.FontHeight * TextScale;
+
   // Check remaining space on current line
-  if (SSD1306_WIDTH < (this->CurrentX + Font.FontWidth) || SSD1306_HEIGHT < (this->CurrentY + Font.FontHeight)) {
+  if (this->Width < (this->CurrentX + View.OriginX + cellW) || this->Height < (this->CurrentY + View.OriginY + cellH)) {
     // Not enough space on current line
     return 0;
   }
 
-  // Use the font to write
-  for (i = 0; i < Font.FontHeight; i++) {
-    b = Font.data[(ch - 32) * Font.FontHeight + i];
-    for (j = 0; j < Font.FontWidth; j++) {
-      if ((b << j) & 0x8000) {
-        drawPixel(this->CurrentX + j, (this->CurrentY + i), (SSD1306_COLOR)color);
-      } else {
-        drawPixel(this->CurrentX + j, (this->CurrentY + i), (SSD1306_COLOR)!color);
-      }
-    }
+  // Hidden glyphs only advance the cursor
+  if (!outsideClip(this->CurrentX, this->CurrentY, cellW, cellH)) {
+    blitGlyph(Font, code, color);
   }
 
   // The current space is now taken
-  this->CurrentX += Font.FontWidth;
+  this->CurrentX += cellW;
 
   // Return written char for validation
-  return c;
+  return ch;
 }
 
-void SSD1306::drawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
-  if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
-    // Don't write outside the buffer
+void SSD1306::drawPixel(int16_t x, int16_t y, SSD1306_COLOR color) {
+  if (pixelOp(color) == SSD1306_ROP_SET) {
+    drawPixel<SSD1306_ROP_SET>(x, y);
+  } else {
+    drawPixel<SSD1306_ROP_CLEAR>(x, y);
+  }
+}
+
+template <uint8_t Op>
+void SSD1306::drawPixel(int16_t x, int16_t y) {
+  x += View.OriginX;
+  y += View.OriginY;
+
+  if (x < View.ClipX0 || x >= View.ClipX1 || y < View.ClipY0 || y >= View.ClipY1) {
+    // Don't write outside the clip rectangle
     return;
   }
 
-  // Check if pixel should be inverted
-  if (this->Inverted) {
-    color = (SSD1306_COLOR)!color;
+  rasterOp<Op>(&SSD1306_Buffer[x + (y / 8) * this->Width], 1 << (y & 7));
+}
+
+void SSD1306::drawRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (w <= 0 || h <= 0 || outsideClip(x, y, w, h)) return;
+
+  SSD1306_RopTarget<SSD1306_ROP_SET> dst(*this);
+  SSD1306_Raster::drawRect(dst, x, y, w, h, SSD1306_WHITE);
+}
+
+void SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color, const uint8_t* pattern) {
+  if (!pattern) pattern = solidPattern;
+
+  switch (color) {
+    case SSD1306_WHITE: fillRect<SSD1306_ROP_SET>(x, y, w, h, pattern); break;
+    case SSD1306_BLACK: fillRect<SSD1306_ROP_CLEAR>(x, y, w, h, pattern); break;
+    case SSD1306_INVERSE: fillRect<SSD1306_ROP_INVERSE>(x, y, w, h, pattern); break;
   }
+}
 
-  // Draw in the right color
-  if (color == SSD1306_WHITE) {
-    SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= (1 << (y & 7));  //1 << (y % 8);
-  } else {
-    SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y & 7));  //~(1 << (y % 8));
+template <uint8_t Op>
+void SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  fillRect<Op>(x, y, w, h, solidPattern);
+}
+
+// Whole page bytes at a time: the rows of the rectangle in this page ANDed
+// with the pattern byte of the column
+template <uint8_t Op>
+void SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* pattern) {
+  if (!clipToViewport(x, y, w, h)) return;
+
+  for (int16_t page = y >> 3; page <= ((y + h - 1) >> 3); page++) {
+    uint8_t rows = clipRows(page, y, y + h);
+    uint8_t* pBuf = &SSD1306_Buffer[page * this->Width];
+
+    for (int16_t i = x; i < x + w; i++) {
+      rasterOp<Op>(&pBuf[i], rows & pattern[i & 7]);
+    }
   }
 }
 
-void SSD1306::drawRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
-  if ((x >= SSD1306_WIDTH) || (y >= SSD1306_HEIGHT)) return;
-  if ((x + w - 1) >= SSD1306_WIDTH) w = SSD1306_WIDTH - x;
-  if ((y + h - 1) >= SSD1306_HEIGHT) h = SSD1306_HEIGHT - y;
+void SSD1306::drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color, uint8_t dash) {
+  if (dash != SSD1306_LINE_SOLID) {
+    // Column n of the pattern is on when bit n of the dash is
+    uint8_t pattern[8];
+    for (uint8_t i = 0; i < 8; i++) pattern[i] = (dash & (1 << i)) ? 0xFF : 0x00;
 
-  uint8_t x2 = x + w - 1;
-  uint8_t y2 = y + h - 1;
+    switch (color) {
+      case SSD1306_WHITE: drawHLine<SSD1306_ROP_SET>(x, y, w, pattern); break;
+      case SSD1306_BLACK: drawHLine<SSD1306_ROP_CLEAR>(x, y, w, pattern); break;
+      case SSD1306_INVERSE: drawHLine<SSD1306_ROP_INVERSE>(x, y, w, pattern); break;
+    }
+    return;
+  }
 
-  drawHLine(x, y, w, SSD1306_WHITE);
-  drawHLine(x, y2, w, SSD1306_WHITE);
-  drawVLine(x, y, h, SSD1306_WHITE);
-  drawVLine(x2, y, h, SSD1306_WHITE);
+  switch (color) {
+    case SSD1306_WHITE: drawHLine<SSD1306_ROP_SET>(x, y, w); break;
+    case SSD1306_BLACK: drawHLine<SSD1306_ROP_CLEAR>(x, y, w); break;
+    case SSD1306_INVERSE: drawHLine<SSD1306_ROP_INVERSE>(x, y, w); break;
+  }
 }
 
-void SSD1306::fillRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, SSD1306_COLOR color) {
-  if ((x >= SSD1306_WIDTH) || (y >= SSD1306_HEIGHT)) return;
-  if ((x + w - 1) >= SSD1306_WIDTH) w = SSD1306_WIDTH - x;
-  if ((y + h - 1) >= SSD1306_HEIGHT) h = SSD1306_HEIGHT - y;
+template <uint8_t Op>
+void SSD1306::drawHLine(int16_t x, int16_t y, int16_t w, const uint8_t* pattern) {
+  int16_t h = 1;
+  if (!clipToViewport(x, y, w, h)) return;
 
-  uint8_t n = 0;
+  uint8_t* pBuf = &SSD1306_Buffer[(y >> 3) * this->Width];
+  uint8_t mask = 1 << (y & 7);
 
-  for (uint8_t j = h; j > 0; j--) {
-    drawHLine(x, y + n, w, color);
-    n++;
+  for (int16_t i = x; i < x + w; i++) {
+    rasterOp<Op>(&pBuf[i], mask & pattern[i & 7]);
   }
 }
 
-void SSD1306::drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color) {
+template <uint8_t Op>
+void SSD1306::drawHLine(int16_t x, int16_t y, int16_t w) {
+  x += View.OriginX;
+  y += View.OriginY;
+
   // Do bounds/limit checks
-  if (y < 0 || y >= SSD1306_HEIGHT) { return; }
+  if (y < View.ClipY0 || y >= View.ClipY1) { return; }
 
-  // make sure we don't try to draw below 0
-  if (x < 0) {
-    w += x;
-    x = 0;
+  // make sure we don't start left of the clip rectangle
+  if (x < View.ClipX0) {
+    w -= View.ClipX0 - x;
+    x = View.ClipX0;
   }
 
-  // make sure we don't go off the edge of the display
-  if ((x + w) > SSD1306_WIDTH) {
-    w = (SSD1306_WIDTH - x);
+  // make sure we don't go off its right edge
+  if ((x + w) > View.ClipX1) {
+    w = (View.ClipX1 - x);
   }
 
   // if our width is now negative, punt
@@ -277,39 +898,53 @@ void SSD1306::drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color) {
   // set up the pointer for  movement through the buffer
   register uint8_t* pBuf = SSD1306_Buffer;
   // adjust the buffer pointer for the current row
-  pBuf += ((y / 8) * SSD1306_WIDTH);
+  pBuf += ((y / 8) * this->Width);
   // and offset x columns in
   pBuf += x;
   register uint8_t mask = 1 << (y & 7);
 
+  while (w--) { rasterOp<Op>(pBuf++, mask); };
+}
+
+void SSD1306::drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR color, uint8_t dash) {
+  if (dash != SSD1306_LINE_SOLID) {
+    // Row n of every column is on when bit n of the dash is
+    uint8_t pattern[8];
+    memset(pattern, dash, sizeof(pattern));
+
+    switch (color) {
+      case SSD1306_WHITE: drawVLine<SSD1306_ROP_SET>(x, y, h, pattern); break;
+      case SSD1306_BLACK: drawVLine<SSD1306_ROP_CLEAR>(x, y, h, pattern); break;
+      case SSD1306_INVERSE: drawVLine<SSD1306_ROP_INVERSE>(x, y, h, pattern); break;
+    }
+    return;
+  }
+
   switch (color) {
-    case SSD1306_WHITE:
-      while (w--) { *pBuf++ |= mask; };
-      break;
-    case SSD1306_BLACK:
-      mask = ~mask;
-      while (w--) { *pBuf++ &= mask; };
-      break;
-    case SSD1306_INVERSE:
-      while (w--) { *pBuf++ ^= mask; };
-      break;
+    case SSD1306_WHITE: drawVLine<SSD1306_ROP_SET>(x, y, h); break;
+    case SSD1306_BLACK: drawVLine<SSD1306_ROP_CLEAR>(x, y, h); break;
+    case SSD1306_INVERSE: drawVLine<SSD1306_ROP_INVERSE>(x, y, h); break;
   }
 }
 
-void SSD1306::drawVLine(int16_t x, int16_t __y, int16_t __h, SSD1306_COLOR color) {
-  // do nothing if we're off the left or right side of the screen
-  if (x < 0 || x >= SSD1306_WIDTH) { return; }
+template <uint8_t Op>
+void SSD1306::drawVLine(int16_t x, int16_t __y, int16_t __h) {
+  x += View.OriginX;
+  __y += View.OriginY;
+
+  // do nothing if we're off the left or right side of the clip rectangle
+  if (x < View.ClipX0 || x >= View.ClipX1) { return; }
 
-  // make sure we don't try to draw below 0
-  if (__y < 0) {
-    // __y is negative, this will subtract enough from __h to account for __y being 0
-    __h += __y;
-    __y = 0;
+  // make sure we don't start above the clip rectangle
+  if (__y < View.ClipY0) {
+    // this will subtract enough from __h to account for __y being ClipY0
+    __h -= View.ClipY0 - __y;
+    __y = View.ClipY0;
   }
 
-  // make sure we don't go past the height of the display
-  if ((__y + __h) > SSD1306_HEIGHT) {
-    __h = (SSD1306_HEIGHT - __y);
+  // make sure we don't go past its bottom
+  if ((__y + __h) > View.ClipY1) {
+    __h = (View.ClipY1 - __y);
   }
 
   // if our height is now negative, punt
@@ -326,7 +961,7 @@ void SSD1306::drawVLine(int16_t x, int16_t __y, int16_t __h, SSD1306_COLOR color
   register uint8_t* pBuf = SSD1306_Buffer;
   // adjust the buffer pointer for the current row
   if (y > 0)
-    pBuf += ((y / 8) * SSD1306_WIDTH);
+    pBuf += ((y / 8) * this->Width);
   // and offset x columns in
   pBuf += x;
 
@@ -346,43 +981,39 @@ void SSD1306::drawVLine(int16_t x, int16_t __y, int16_t __h, SSD1306_COLOR color
       mask &= (0XFF >> (mod - h));
     }
 
-    switch (color) {
-      case SSD1306_WHITE: *pBuf |= mask; break;
-      case SSD1306_BLACK: *pBuf &= ~mask; break;
-      case SSD1306_INVERSE: *pBuf ^= mask; break;
-    }
+    rasterOp<Op>(pBuf, mask);
 
     // fast exit if we're done here!
     if (h < mod) { return; }
 
     h -= mod;
 
-    pBuf += SSD1306_WIDTH;
+    pBuf += this->Width;
   }
 
 
   // write solid bytes while we can - effectively doing 8 rows at a time
   if (h >= 8) {
-    if (color == SSD1306_INVERSE) {  // separate copy of the code so we don't impact performance of the black/white write version with an extra comparison per loop
+    if (Op == SSD1306_ROP_INVERSE) {  // separate copy of the code so we don't impact performance of the black/white write version with an extra comparison per loop
       do {
         *pBuf = ~(*pBuf);
 
         // adjust the buffer forward 8 rows worth of data
-        pBuf += SSD1306_WIDTH;
+        pBuf += this->Width;
 
         // adjust h & y (there's got to be a faster way for me to do this, but this should still help a fair bit for now)
         h -= 8;
       } while (h >= 8);
     } else {
       // store a local value to work with
-      register uint8_t val = (color == SSD1306_WHITE) ? 255 : 0;
+      register uint8_t val = (Op == SSD1306_ROP_SET) ? 255 : 0;
 
       do {
         // write our value in
         *pBuf = val;
 
         // adjust the buffer forward 8 rows worth of data
-        pBuf += SSD1306_WIDTH;
+        pBuf += this->Width;
 
         // adjust h & y (there's got to be a faster way for me to do this, but this should still help a fair bit for now)
         h -= 8;
@@ -398,15 +1029,25 @@ void SSD1306::drawVLine(int16_t x, int16_t __y, int16_t __h, SSD1306_COLOR color
     // note - lookup table results in a nearly 10% performance improvement in fill* functions
     static uint8_t postmask[8] = { 0x00, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F };
     register uint8_t mask = postmask[mod];
-    switch (color) {
-      case SSD1306_WHITE: *pBuf |= mask; break;
-      case SSD1306_BLACK: *pBuf &= ~mask; break;
-      case SSD1306_INVERSE: *pBuf ^= mask; break;
-    }
+    rasterOp<Op>(pBuf, mask);
+  }
+}
+
+template <uint8_t Op>
+void SSD1306::drawVLine(int16_t x, int16_t y, int16_t h, const uint8_t* pattern) {
+  int16_t w = 1;
+  if (!clipToViewport(x, y, w, h)) return;
+
+  uint8_t bits = pattern[x & 7];
+  for (int16_t page = y >> 3; page <= ((y + h - 1) >> 3); page++) {
+    rasterOp<Op>(&SSD1306_Buffer[page * this->Width + x], clipRows(page, y, y + h) & bits);
   }
 }
 
-void SSD1306::drawImage(uint8_t* img, uint8_t x, uint8_t y, uint8_t w, uint8_t h, SSD1306_COLOR color, SSD1306_COLOR bg) {
+void SSD1306::drawImage(uint8_t* img, int16_t x, int16_t y, uint8_t w, uint8_t h, SSD1306_COLOR color, SSD1306_COLOR bg) {
+  // Rows are drawn from y + 1 on
+  if (outsideClip(x, y + 1, w, h)) return;
+
   uint8_t bits = 0x80;
   uint8_t bw = (w + 7) / 8;  // Bitmask scanline pad = whole byte
   uint8_t data = img[0];
@@ -428,285 +1069,401 @@ void SSD1306::drawImage(uint8_t* img, uint8_t x, uint8_t y, uint8_t w, uint8_t h
   }
 }
 
+// Draw a page-format bitmap (see SSD1306_Bitmap.h), set bits are drawn in `color`,
+// clear bits are transparent. Each source byte is shifted into at most two
+// destination pages, no per-pixel work is done.
+void SSD1306::drawBitmap(const uint8_t* pages, int16_t x, int16_t y, uint8_t w, uint8_t h, SSD1306_COLOR color) {
+  if (outsideClip(x, y, w, h)) return;
+
+  x += View.OriginX;
+  y += View.OriginY;
+
+  // Clip columns to the clip rectangle
+  int16_t c0 = (x < View.ClipX0) ? View.ClipX0 - x : 0;
+  int16_t c1 = (x + w > View.ClipX1) ? View.ClipX1 - x : w;
+
+  uint8_t srcPages = (h + 7) >> 3;
+  uint8_t shift = y & 7;
+  int16_t page = (y - shift) / 8;
+
+  for (uint8_t sp = 0; sp < srcPages; sp++) {
+    // Drop the padding rows of the last source page
+    uint8_t rowmask = (sp == srcPages - 1 && (h & 7)) ? (0xFF >> (8 - (h & 7))) : 0xFF;
+    int16_t dp = page + sp;
+    if (dp * 8 >= View.ClipY1) break;
+
+    // Rows of both destination pages that are inside the clip rectangle
+    uint8_t loMask = clipRows(dp, View.ClipY0, View.ClipY1);
+    uint8_t hiMask = shift ? clipRows(dp + 1, View.ClipY0, View.ClipY1) : 0;
+
+    const uint8_t* src = &pages[sp * w];
+    uint8_t* lo = loMask ? &SSD1306_Buffer[dp * this->Width] : NULL;
+    uint8_t* hi = hiMask ? &SSD1306_Buffer[(dp + 1) * this->Width] : NULL;
+
+    for (int16_t c = c0; c < c1; c++) {
+      uint16_t bits = (uint16_t)(src[c] & rowmask) << shift;
+      uint8_t l = (uint8_t)bits & loMask;
+      uint8_t u = (uint8_t)(bits >> 8) & hiMask;
+      int16_t dx = x + c;
+
+      switch (color) {
+        case SSD1306_WHITE:
+          if (lo) lo[dx] |= l;
+          if (hi) hi[dx] |= u;
+          break;
+        case SSD1306_BLACK:
+          if (lo) lo[dx] &= ~l;
+          if (hi) hi[dx] &= ~u;
+          break;
+        case SSD1306_INVERSE:
+          if (lo) lo[dx] ^= l;
+          if (hi) hi[dx] ^= u;
+          break;
+      }
+    }
+  }
+}
 
-void SSD1306::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
-  int16_t max_radius = ((w < h) ? w : h) / 2;  // 1/2 minor axis
-  if (r > max_radius)
-    r = max_radius;
-  // smarter version
-  drawHLine(x + r, y, w - 2 * r, color);          // Top
-  drawHLine(x + r, y + h - 1, w - 2 * r, color);  // Bottom
-  drawVLine(x, y + r, h - 2 * r, color);          // Left
-  drawVLine(x + w - 1, y + r, h - 2 * r, color);  // Right
-  // draw four corners
-  drawCircleHelper(x + r, y + r, r, 1, color);
-  drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
-  drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
-  drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
-}
-
-void SSD1306::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
-  int16_t max_radius = ((w < h) ? w : h) / 2; // 1/2 minor axis
-  if (r > max_radius)
-    r = max_radius;
-  // smarter version
-  fillRect(x + r, y, w - 2 * r, h, color);
-  // draw four corners
-  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
-  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+// Rows of column x in `page` that are inside the clip rectangle, still have
+// the target value and have not been filled yet
+uint8_t SSD1306::floodRows(int16_t x, int16_t page, uint8_t target, const uint8_t* visited) const {
+  uint16_t i = page * this->Width + x;
+  uint8_t rows = target ? SSD1306_Buffer[i] : ~SSD1306_Buffer[i];
+
+  if (visited) rows &= ~visited[i];
+  return rows & clipRows(page, View.ClipY0, View.ClipY1);
 }
 
-void SSD1306::drawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
-int16_t f = 1 - r;
-  int16_t ddF_x = 1;
-  int16_t ddF_y = -2 * r;
-  int16_t x = 0;
-  int16_t y = r;
-
-  drawPixel(x0, y0 + r, color);
-  drawPixel(x0, y0 - r, color);
-  drawPixel(x0 + r, y0, color);
-  drawPixel(x0 - r, y0, color);
-
-  while (x < y) {
-    if (f >= 0) {
-      y--;
-      ddF_y += 2;
-      f += ddF_y;
+// Grow the run of fillable rows through `y` in column x to its first and last row
+void SSD1306::floodExtent(int16_t x, int16_t y, uint8_t target, const uint8_t* visited, int16_t& top, int16_t& bottom) const {
+  int16_t pages = this->Height / 8;
+
+  top = y;
+  for (int16_t page = y >> 3; page >= 0; page--) {
+    // Blocking rows at or above `top` in this page, the lowest one ends the run
+    uint8_t stop = ~floodRows(x, page, target, visited) & (0xFF >> (7 - (top & 7)));
+    if (stop) {
+      top = page * 8 + 32 - __builtin_clz(stop);
+      break;
     }
-    x++;
-    ddF_x += 2;
-    f += ddF_x;
+    top = page * 8;
+    if (page > 0) top--;
+  }
 
-    drawPixel(x0 + x, y0 + y, color);
-    drawPixel(x0 - x, y0 + y, color);
-    drawPixel(x0 + x, y0 - y, color);
-    drawPixel(x0 - x, y0 - y, color);
-    drawPixel(x0 + y, y0 + x, color);
-    drawPixel(x0 - y, y0 + x, color);
-    drawPixel(x0 + y, y0 - x, color);
-    drawPixel(x0 - y, y0 - x, color);
+  bottom = y;
+  for (int16_t page = y >> 3; page < pages; page++) {
+    uint8_t stop = ~floodRows(x, page, target, visited) & (0xFF << (bottom & 7));
+    if (stop) {
+      bottom = page * 8 + __builtin_ctz(stop) - 1;
+      break;
+    }
+    bottom = page * 8 + 7;
+    if (page + 1 < pages) bottom++;
   }
 }
 
-void SSD1306::fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
-  drawVLine(x0, y0 - r, 2 * r + 1, color);
-  fillCircleHelper(x0, y0, r, 3, 0, color);
+// Pending scan of column x over rows [y0, y1], entered from column x - dir
+// (0 for seeds). The rows [y0, y1] of that column are already filled.
+typedef struct {
+  int16_t x, y0, y1;
+  int8_t dir;
+} FloodSpan;
+
+static bool floodPush(FloodSpan* stack, uint16_t& depth, int16_t x, int16_t y0, int16_t y1, int8_t dir) {
+  if (depth == SSD1306_FLOOD_STACK) return false;
+
+  stack[depth].x = x;
+  stack[depth].y0 = y0;
+  stack[depth].y1 = y1;
+  stack[depth].dir = dir;
+  depth++;
+  return true;
 }
 
-void SSD1306::drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, SSD1306_COLOR color) {
-int16_t f = 1 - r;
-  int16_t ddF_x = 1;
-  int16_t ddF_y = -2 * r;
-  int16_t x = 0;
-  int16_t y = r;
-
-  while (x < y) {
-    if (f >= 0) {
-      y--;
-      ddF_y += 2;
-      f += ddF_y;
-    }
-    x++;
-    ddF_x += 2;
-    f += ddF_x;
-    if (cornername & 0x4) {
-      drawPixel(x0 + x, y0 + y, color);
-      drawPixel(x0 + y, y0 + x, color);
-    }
-    if (cornername & 0x2) {
-      drawPixel(x0 + x, y0 - y, color);
-      drawPixel(x0 + y, y0 - x, color);
-    }
-    if (cornername & 0x8) {
-      drawPixel(x0 - y, y0 + x, color);
-      drawPixel(x0 - x, y0 + y, color);
+// Fill the 4-connected area around x, y. The area is walked in vertical runs
+// since a byte holds 8 rows of one column: whole bytes are tested and filled
+// at once. Like a scanline fill, a run continues into the next column and
+// turns back only where it overhangs the run it came from, so the fixed
+// stack holds few spans. Filled pixels are recorded in `scratch`, which lets
+// a pattern fill leave pixels at the old value and lets an overflowing stack
+// be recovered by reseeding from the recorded area.
+bool SSD1306::floodFill(int16_t x, int16_t y, SSD1306_COLOR color, uint8_t* scratch, const uint8_t* pattern) {
+  if (!scratch) return false;
+
+  x += View.OriginX;
+  y += View.OriginY;
+  if (x < View.ClipX0 || x >= View.ClipX1 || y < View.ClipY0 || y >= View.ClipY1) return true;
+
+  uint8_t target = (SSD1306_Buffer[x + (y / 8) * this->Width] >> (y & 7)) & 1;
+
+  if (!pattern) {
+    uint8_t value = (color == SSD1306_INVERSE) ? !target : (color == SSD1306_WHITE);
+    if (value == target) return true;
+    pattern = solidPattern;
+  }
+  memset(scratch, 0, SSD1306_BUFFER_SIZE);
+
+  FloodSpan stack[SSD1306_FLOOD_STACK];
+  uint16_t depth = 0;
+  bool overflow = false;
+
+  floodPush(stack, depth, x, y, y, 0);
+
+  for (;;) {
+    while (depth) {
+      FloodSpan span = stack[--depth];
+      int16_t cx = span.x;
+
+      // Every run of column cx that touches [y0, y1] belongs to the area
+      for (int16_t cy = span.y0; cy <= span.y1;) {
+        int16_t page = cy >> 3;
+        uint8_t rows = floodRows(cx, page, target, scratch) & clipRows(page, cy, span.y1 + 1);
+        if (!rows) {
+          cy = page * 8 + 8;
+          continue;
+        }
+
+        int16_t top, bottom;
+        floodExtent(cx, page * 8 + __builtin_ctz(rows), target, scratch, top, bottom);
+
+        for (int16_t p = top >> 3; p <= (bottom >> 3); p++) {
+          uint8_t mask = clipRows(p, top, bottom + 1);
+          uint8_t* pBuf = &SSD1306_Buffer[p * this->Width + cx];
+
+          scratch[p * this->Width + cx] |= mask;
+          switch (color) {
+            case SSD1306_WHITE: rasterOp<SSD1306_ROP_SET>(pBuf, mask & pattern[cx & 7]); break;
+            case SSD1306_BLACK: rasterOp<SSD1306_ROP_CLEAR>(pBuf, mask & pattern[cx & 7]); break;
+            case SSD1306_INVERSE: rasterOp<SSD1306_ROP_INVERSE>(pBuf, mask & pattern[cx & 7]); break;
+          }
+        }
+
+        // Onwards over the whole run, back only where it overhangs the parent
+        for (int8_t dir = -1; dir <= 1; dir += 2) {
+          int16_t nx = cx + dir;
+          if (nx < View.ClipX0 || nx >= View.ClipX1) continue;
+
+          if (!span.dir || dir == span.dir) {
+            overflow |= !floodPush(stack, depth, nx, top, bottom, dir);
+          } else {
+            if (top < span.y0) overflow |= !floodPush(stack, depth, nx, top, span.y0 - 1, dir);
+            if (bottom > span.y1) overflow |= !floodPush(stack, depth, nx, span.y1 + 1, bottom, dir);
+          }
+        }
+        cy = bottom + 2;
+      }
     }
-    if (cornername & 0x1) {
-      drawPixel(x0 - y, y0 - x, color);
-      drawPixel(x0 - x, y0 - y, color);
+
+    if (!overflow) return true;
+
+    // Runs were dropped: seed again from fillable pixels next to the filled
+    // area. A sweep seeds one run per byte, so repeat until one finds none.
+    int16_t pages = this->Height / 8;
+    for (int16_t cx = View.ClipX0; cx < View.ClipX1 && depth < SSD1306_FLOOD_STACK; cx++) {
+      for (int16_t page = View.ClipY0 >> 3; page <= ((View.ClipY1 - 1) >> 3) && depth < SSD1306_FLOOD_STACK; page++) {
+        uint16_t i = page * this->Width + cx;
+        uint8_t near = (scratch[i] << 1) | (scratch[i] >> 1);
+
+        if (page > 0) near |= scratch[i - this->Width] >> 7;
+        if (page + 1 < pages) near |= scratch[i + this->Width] << 7;
+        if (cx > View.ClipX0) near |= scratch[i - 1];
+        if (cx + 1 < View.ClipX1) near |= scratch[i + 1];
+
+        uint8_t seed = floodRows(cx, page, target, scratch) & near;
+        if (!seed) continue;
+
+        int16_t sy = page * 8 + __builtin_ctz(seed);
+        floodPush(stack, depth, cx, sy, sy, 0);
+      }
     }
+    if (!depth) return true;
   }
 }
 
-void SSD1306::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, SSD1306_COLOR color) {
-  int16_t f = 1 - r;
-  int16_t ddF_x = 1;
-  int16_t ddF_y = -2 * r;
-  int16_t x = 0;
-  int16_t y = r;
-  int16_t px = x;
-  int16_t py = y;
-
-  delta++; // Avoid some +1's in the loop
-
-  while (x < y) {
-    if (f >= 0) {
-      y--;
-      ddF_y += 2;
-      f += ddF_y;
-    }
-    x++;
-    ddF_x += 2;
-    f += ddF_x;
-    // These checks avoid double-drawing certain lines, important
-    // for the SSD1306 library which has an INVERT drawing mode.
-    if (x < (y + 1)) {
-      if (corners & 1)
-        drawVLine(x0 + x, y0 - y, 2 * y + delta, color);
-      if (corners & 2)
-        drawVLine(x0 - x, y0 - y, 2 * y + delta, color);
-    }
-    if (y != py) {
-      if (corners & 1)
-        drawVLine(x0 + py, y0 - px, 2 * px + delta, color);
-      if (corners & 2)
-        drawVLine(x0 - py, y0 - px, 2 * px + delta, color);
-      py = y;
-    }
-    px = x;
+// Restrict the span [a, a + len) to the part that lies inside [b0, b1) after
+// moving it by d, false if nothing is left
+static bool shiftSpan(int16_t& a, int16_t& len, int16_t d, int16_t b0, int16_t b1) {
+  int16_t s0 = a, s1 = a + len;
+
+  if (s0 < b0 - d) s0 = b0 - d;
+  if (s1 > b1 - d) s1 = b1 - d;
+  if (s0 >= s1) return false;
+
+  a = s0;
+  len = s1 - s0;
+  return true;
+}
+
+void SSD1306::moveRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, SSD1306_COLOR fill) {
+  if (!clipToViewport(x, y, w, h)) return;
+  if (!dx && !dy) return;
+
+  // Whatever lands inside the clip rectangle is copied
+  int16_t sx = x, sy = y, sw = w, sh = h;
+  if (shiftSpan(sx, sw, dx, View.ClipX0, View.ClipX1) && shiftSpan(sy, sh, dy, View.ClipY0, View.ClipY1)) {
+    copyArea(sx, sy, sw, sh, dx, dy);
   }
+  fillExposed(x, y, w, h, dx, dy, fill);
 }
 
-void SSD1306::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
-  drawLine(x0, y0, x1, y1, color);
-  drawLine(x1, y1, x2, y2, color);
-  drawLine(x2, y2, x0, y0, color);
+void SSD1306::scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, SSD1306_COLOR fill) {
+  if (!clipToViewport(x, y, w, h)) return;
+  if (!dx && !dy) return;
+
+  // Only what stays inside the area is copied
+  int16_t sx = x, sy = y, sw = w, sh = h;
+  if (shiftSpan(sx, sw, dx, x, x + w) && shiftSpan(sy, sh, dy, y, y + h)) {
+    copyArea(sx, sy, sw, sh, dx, dy);
+  }
+  fillExposed(x, y, w, h, dx, dy, fill);
 }
 
-void SSD1306::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
+// Copy the w x h area at x, y (buffer coordinates) to x + dx, y + dy. Whole
+// bytes are moved: a vertical move combines two source pages per destination
+// byte. Pages and columns are walked against the direction of the move, so
+// every source byte is read before it is overwritten.
+void SSD1306::copyArea(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy) {
+  int16_t pages = this->Height / 8;
+  int16_t y0 = y + dy, y1 = y0 + h;
+  int16_t p0 = y0 >> 3, p1 = (y1 - 1) >> 3;
+
+  for (int16_t n = 0; n <= p1 - p0; n++) {
+    int16_t p = (dy > 0) ? p1 - n : p0 + n;
+    uint8_t mask = clipRows(p, y0, y1);
+    uint8_t* dst = &SSD1306_Buffer[p * this->Width + x + dx];
+
+    // The rows of this page come from source row s on, in pages sp and sp + 1
+    int16_t s = p * 8 - dy;
+    int16_t sp = (s < 0) ? -((7 - s) >> 3) : (s >> 3);
+    uint8_t shift = s - sp * 8;
+    const uint8_t* lo = (sp >= 0 && sp < pages) ? &SSD1306_Buffer[sp * this->Width + x] : NULL;
+    const uint8_t* hi = (shift && sp + 1 < pages) ? &SSD1306_Buffer[(sp + 1) * this->Width + x] : NULL;
+
+    if (mask == 0xFF && !shift) {
+      memmove(dst, lo, w);
+      continue;
+    }
 
-  int16_t a, b, y, last;
+    for (int16_t i = 0; i < w; i++) {
+      int16_t c = (dx > 0) ? w - 1 - i : i;
+      uint8_t bits = lo ? lo[c] >> shift : 0;
 
-  // Sort coordinates by Y order (y2 >= y1 >= y0)
-  if (y0 > y1) {
-    swap16(y0, y1);
-    swap16(x0, x1);
-  }
-  if (y1 > y2) {
-    swap16(y2, y1);
-    swap16(x2, x1);
-  }
-  if (y0 > y1) {
-    swap16(y0, y1);
-    swap16(x0, x1);
+      if (hi) bits |= hi[c] << (8 - shift);
+      dst[c] = (dst[c] & ~mask) | (bits & mask);
+    }
   }
+}
 
-  if (y0 == y2) { // Handle awkward all-on-same-line case as its own thing
-    a = b = x0;
-    if (x1 < a)
-      a = x1;
-    else if (x1 > b)
-      b = x1;
-    if (x2 < a)
-      a = x2;
-    else if (x2 > b)
-      b = x2;
-    drawHLine(a, y0, b - a + 1, color);
-    return;
+// Fill the part of the w x h area at x, y (buffer coordinates) that a move
+// by dx, dy does not cover: a band of columns, then a band of rows beside it
+void SSD1306::fillExposed(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, SSD1306_COLOR fill) {
+  int16_t cols = (dx < 0) ? -dx : dx;
+  int16_t rows = (dy < 0) ? -dy : dy;
+
+  if (cols > w) cols = w;
+  if (rows > h) rows = h;
+  x -= View.OriginX;
+  y -= View.OriginY;
+
+  if (cols) fillRect((dx > 0) ? x : x + w - cols, y, cols, h, fill);
+  if (rows && cols < w) {
+    fillRect((dx > 0) ? x + cols : x, (dy > 0) ? y : y + h - rows, w - cols, rows, fill);
   }
+}
+
+void SSD1306::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+  if (outsideClip(x, y, w, h)) return;
+
+  SSD1306_WITH_OPS(color, SSD1306_Raster::drawRoundRect(dst, x, y, w, h, r, color));
+}
 
-  int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0,
-          dx12 = x2 - x1, dy12 = y2 - y1;
-  int32_t sa = 0, sb = 0;
-
-  // For upper part of triangle, find scanline crossings for segments
-  // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
-  // is included here (and second loop will be skipped, avoiding a /0
-  // error there), otherwise scanline y1 is skipped here and handled
-  // in the second loop...which also avoids a /0 error here if y0=y1
-  // (flat-topped triangle).
-  if (y1 == y2)
-    last = y1; // Include y1 scanline
-  else
-    last = y1 - 1; // Skip it
-
-  for (y = y0; y <= last; y++) {
-    a = x0 + sa / dy01;
-    b = x0 + sb / dy02;
-    sa += dx01;
-    sb += dx02;
-    /* longhand:
-    a = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
-    b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
-    */
-    if (a > b)
-      swap16(a, b);
-    drawHLine(a, y, b - a + 1, color);
-  }
-
-  // For lower part of triangle, find scanline crossings for segments
-  // 0-2 and 1-2.  This loop is skipped if y1=y2.
-  sa = (int32_t)dx12 * (y - y1);
-  sb = (int32_t)dx02 * (y - y0);
-  for (; y <= y2; y++) {
-    a = x1 + sa / dy12;
-    b = x0 + sb / dy02;
-    sa += dx12;
-    sb += dx02;
-    /* longhand:
-    a = x1 + (x2 - x1) * (y - y1) / (y2 - y1);
-    b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
-    */
-    if (a > b)
-      swap16(a, b);
-    drawHLine(a, y, b - a + 1, color);
-  }
-
-}
-
-void SSD1306::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
-  // Update in subclasses if desired!
-  if (x0 == x1) {
-    if (y0 > y1)
-      swap16(y0, y1);
-    drawVLine(x0, y0, y1 - y0 + 1, color);
-  } else if (y0 == y1) {
-    if (x0 > x1)
-      swap16(x0, x1);
-    drawHLine(x0, y0, x1 - x0 + 1, color);
+void SSD1306::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color, const uint8_t* pattern) {
+  if (outsideClip(x, y, w, h)) return;
+
+  if (pattern) {
+    SSD1306_WITH_PATTERN_OP(color, pattern, SSD1306_Raster::fillRoundRect(dst, x, y, w, h, r, color));
   } else {
-    writeLine(x0, y0, x1, y1, color);
+    SSD1306_WITH_LINE_OP(color, SSD1306_Raster::fillRoundRect(dst, x, y, w, h, r, color));
   }
 }
 
-void SSD1306::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
+void SSD1306::drawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+  if (outsideClip(x0 - r, y0 - r, 2 * r + 1, 2 * r + 1)) return;
 
-  int16_t steep = abs(y1 - y0) > abs(x1 - x0);
-  if (steep) {
-    swap16(x0, y0);
-    swap16(x1, y1);
-  }
+  SSD1306_WITH_PIXEL_OP(color, SSD1306_Raster::drawCircle(dst, x0, y0, r, color));
+}
+
+void SSD1306::fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color, const uint8_t* pattern) {
+  if (outsideClip(x0 - r, y0 - r, 2 * r + 1, 2 * r + 1)) return;
 
-  if (x0 > x1) {
-    swap16(x0, x1);
-    swap16(y0, y1);
+  if (pattern) {
+    SSD1306_WITH_PATTERN_OP(color, pattern, SSD1306_Raster::fillCircle(dst, x0, y0, r, color));
+  } else {
+    SSD1306_WITH_LINE_OP(color, SSD1306_Raster::fillCircle(dst, x0, y0, r, color));
   }
+}
+
+void SSD1306::drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, SSD1306_COLOR color) {
+  if (outsideClip(x0 - r, y0 - r, 2 * r + 1, 2 * r + 1)) return;
+
+  SSD1306_WITH_PIXEL_OP(color, SSD1306_Raster::drawCircleHelper(dst, x0, y0, r, cornername, color));
+}
+
+void SSD1306::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, SSD1306_COLOR color) {
+  if (outsideClip(x0 - r, y0 - r, 2 * r + 1, 2 * r + 1 + delta)) return;
 
-  int16_t dx, dy;
-  dx = x1 - x0;
-  dy = abs(y1 - y0);
+  SSD1306_WITH_LINE_OP(color, SSD1306_Raster::fillCircleHelper(dst, x0, y0, r, corners, delta, color));
+}
 
-  int16_t err = dx / 2;
-  int16_t ystep;
+void SSD1306::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
+  if (triangleOutsideClip(x0, y0, x1, y1, x2, y2)) return;
+
+  SSD1306_WITH_OPS(color, SSD1306_Raster::drawTriangle(dst, x0, y0, x1, y1, x2, y2, color));
+}
 
-  if (y0 < y1) {
-    ystep = 1;
+void SSD1306::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color, const uint8_t* pattern) {
+  if (triangleOutsideClip(x0, y0, x1, y1, x2, y2)) return;
+
+  if (pattern) {
+    SSD1306_WITH_PATTERN_OP(color, pattern, SSD1306_Raster::fillTriangle(dst, x0, y0, x1, y1, x2, y2, color));
   } else {
-    ystep = -1;
+    SSD1306_WITH_LINE_OP(color, SSD1306_Raster::fillTriangle(dst, x0, y0, x1, y1, x2, y2, color));
   }
+}
 
-  for (; x0 <= x1; x0++) {
-    if (steep) {
-      drawPixel(y0, x0, color);
-    } else {
-      drawPixel(x0, y0, color);
-    }
-    err -= dy;
-    if (err < 0) {
-      y0 += ystep;
-      err += dx;
-    }
+void SSD1306::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color, uint8_t dash) {
+  if (triangleOutsideClip(x0, y0, x1, y1, x1, y1)) return;
+
+  if (dash != SSD1306_LINE_SOLID) {
+    // The dash runs along the major axis, as for drawHLine/drawVLine. All
+    // pixels of a dashed line use the line raster op (SSD1306_INVERSE toggles).
+    uint8_t pattern[8];
+    bool steep = SSD1306_Raster::iabs(y1 - y0) > SSD1306_Raster::iabs(x1 - x0);
+    for (uint8_t i = 0; i < 8; i++) pattern[i] = steep ? dash : ((dash & (1 << i)) ? 0xFF : 0x00);
+
+    SSD1306_WITH_PATTERN_OP(color, pattern, SSD1306_Raster::drawLine(dst, x0, y0, x1, y1, color));
+    return;
   }
+
+  SSD1306_WITH_OPS(color, SSD1306_Raster::drawLine(dst, x0, y0, x1, y1, color));
+}
+
+void SSD1306::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
+  if (triangleOutsideClip(x0, y0, x1, y1, x1, y1)) return;
+
+  SSD1306_WITH_PIXEL_OP(color, SSD1306_Raster::writeLine(dst, x0, y0, x1, y1, color));
 }
 
+// The raster-op primitives are also used from outside, see SSD1306_RopTarget
+#define SSD1306_INSTANTIATE_ROP(Op) \
+  template void SSD1306::drawPixel<Op>(int16_t x, int16_t y); \
+  template void SSD1306::drawHLine<Op>(int16_t x, int16_t y, int16_t w); \
+  template void SSD1306::drawVLine<Op>(int16_t x, int16_t y, int16_t h); \
+  template void SSD1306::fillRect<Op>(int16_t x, int16_t y, int16_t w, int16_t h); \
+  template void SSD1306::drawHLine<Op>(int16_t x, int16_t y, int16_t w, const uint8_t* pattern); \
+  template void SSD1306::drawVLine<Op>(int16_t x, int16_t y, int16_t h, const uint8_t* pattern); \
+  template void SSD1306::fillRect<Op>(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* pattern);
+
+SSD1306_INSTANTIATE_ROP(SSD1306_ROP_SET)
+SSD1306_INSTANTIATE_ROP(SSD1306_ROP_CLEAR)
+SSD1306_INSTANTIATE_ROP(SSD1306_ROP_INVERSE)
@@ -14,6 +14,39 @@
 #define SSD1306_WIDTH 128
 #endif
 
+// Size of one framebuffer in bytes
+#define SSD1306_BUFFER_SIZE (SSD1306_HEIGHT * SSD1306_WIDTH / 8)
+
+// Alignment of framebuffers handed to the driver. 4 bytes lets the SPI DMA of
+// the ESP32 read them in place, which also needs them in internal RAM
+// (MALLOC_CAP_DMA); PSRAM buffers work, but are copied by the SPI driver.
+#ifndef SSD1306_BUFFER_ALIGN
+#define SSD1306_BUFFER_ALIGN 4
+#endif
+
+// Define SSD1306_NO_DEFAULT_BUFFER to drop the framebuffer inside the SSD1306
+// object, a buffer must then be passed to the constructor. This changes the
+// layout of the class, so it has to be a global build flag seen by every file
+// that includes this header (e.g. build_flags = -DSSD1306_NO_DEFAULT_BUFFER in
+// platformio.ini), not a #define in a sketch.
+
+// Toggle DC/CS through the GPIO set/clear registers instead of digitalWrite().
+// setFastGpio(false) switches to the portable path at runtime, defining
+// SSD1306_NO_FAST_GPIO as a global build flag compiles the register path out.
+#if !defined(SSD1306_NO_FAST_GPIO) && (defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266))
+#define SSD1306_FAST_GPIO
+#endif
+
+// Maximum nesting of pushViewport()
+#ifndef SSD1306_VIEWPORT_DEPTH
+#define SSD1306_VIEWPORT_DEPTH 4
+#endif
+
+// Pending column spans of floodFill(), 8 bytes each on the caller's stack
+#ifndef SSD1306_FLOOD_STACK
+#define SSD1306_FLOOD_STACK 64
+#endif
+
 enum {
   SSD1306_SETLOWCOLUMN = 0x00,
   SSD1306_SETHIGHCOLUMN = 0x10,
@@ -61,60 +94,245 @@ enum ScrollMode {
   VERTICAL_AND_LEFT_HORIZONTAL_SCROLL = 0x2A
 };
 
+// Storage for one framebuffer with the required alignment, for static pools:
+//   static SSD1306_Framebuffer screens[2];
+//   SSD1306 oled(MOSI, CLK, DC, RST, CS, &bus, screens[0].data);
+typedef struct alignas(SSD1306_BUFFER_ALIGN) {
+  uint8_t data[SSD1306_BUFFER_SIZE];
+} SSD1306_Framebuffer;
+
 enum SSD1306_COLOR {
   SSD1306_BLACK = 0,
   SSD1306_WHITE = 1,
   SSD1306_INVERSE = 2
 };
 
+// 8x8 fill patterns, one byte per column (LSB is the top row) like the
+// framebuffer, so a pattern byte is ANDed straight into a page byte
+extern const uint8_t SSD1306_PATTERN_CHECKER[8];     // 50 %
+extern const uint8_t SSD1306_PATTERN_DOTS[8];        // 12.5 %
+extern const uint8_t SSD1306_PATTERN_HATCH_DOWN[8];  // diagonal, top left to bottom right
+extern const uint8_t SSD1306_PATTERN_HATCH_UP[8];    // diagonal, bottom left to top right
+extern const uint8_t SSD1306_PATTERN_GRID[8];        // 8 pixel grid
+
+// Dash masks for lines, bit n draws the pixels at n modulo 8 along the line
+#define SSD1306_LINE_SOLID 0xFF
+#define SSD1306_LINE_DOTTED 0x55
+#define SSD1306_LINE_DASHED 0x0F
+#define SSD1306_LINE_DASH_DOT 0x27
+
+// Flags for setTextStyle()
+enum TextStyle {
+  TEXT_OPAQUE = 0x00,       // background of the glyph cell is painted too
+  TEXT_TRANSPARENT = 0x01,  // only the glyph pixels are drawn
+  TEXT_BOLD = 0x02          // every glyph column is also drawn one font pixel to the right
+};
+
+// Raster operation applied to the framebuffer bits a primitive covers
+// (same values as the SSD1306_COLOR that lines and fills map to it)
+enum SSD1306_ROP {
+  SSD1306_ROP_CLEAR = 0,
+  SSD1306_ROP_SET = 1,
+  SSD1306_ROP_INVERSE = 2
+};
+
 class SSD1306 {
 public:
-  SSD1306(int8_t mosi_pin, int8_t sclk_pin, int8_t dc_pin, int8_t rst_pin, int8_t cs_pin);
+  // `bus` and `buffer` stay owned by the caller. Without a bus the driver
+  // allocates its own SPIClass(HSPI), without a buffer it uses the built-in one.
+  // `buffer` is SSD1306_BUFFER_SIZE bytes aligned to SSD1306_BUFFER_ALIGN and
+  // is what setBuffer(NULL) binds, it is required with SSD1306_NO_DEFAULT_BUFFER.
+  SSD1306(int8_t mosi_pin, int8_t sclk_pin, int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
+          SPIClass* bus = NULL, uint8_t* buffer = NULL);
+  ~SSD1306();
+  // Owns its SPIClass and may point into itself, pass it by reference
+  SSD1306(const SSD1306&) = delete;
+  SSD1306& operator=(const SSD1306&) = delete;
   void init();
+#if defined(ARDUINO_ARCH_ESP32)
+  // Let the SPI peripheral drive CS, call before init()
+  void setHardwareCS(bool enable) { this->HwCs = enable; }
+#endif
+  // Toggle DC/CS through the GPIO registers (default where SSD1306_FAST_GPIO
+  // is available) or through digitalWrite(), can be switched at any time
+  void setFastGpio(bool enable);
   void display();
+  // Flush only the page spans marked with markDirty() since the last flush
+  void displayDirty();
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  // Resumable flush for time-constrained loops, true when the frame is complete
+  bool flushPages(uint8_t n, bool dirtyOnly = false);
+  // Sends at least one page (or dirty span) per call, more while they fit in budget_us
+  bool flushStep(uint32_t budget_us, bool dirtyOnly = false);
+  bool flushBusy() const { return FlushActive; }
+  // Number of frames completely sent by any of the flush functions
+  uint32_t frameSequence() const { return FrameSeq; }
   void clear(SSD1306_COLOR color = SSD1306_BLACK);
+  // Framebuffer in page format, width() bytes per page
+  uint8_t* getBuffer() { return SSD1306_Buffer; }
+  // Bind a SSD1306_BUFFER_SIZE byte framebuffer as draw and flush target, NULL
+  // selects the default one (see the constructor). With show set the whole screen is marked dirty,
+  // clear it to only render into the buffer in the background.
+  // Returns the previously bound buffer.
+  uint8_t* setBuffer(uint8_t* buffer, bool show = true);
+  // Copy a prebuilt frame (e.g. a constexpr SSD1306_Canvas) into the bound buffer
+  // and mark it dirty, so it can still be drawn over
+  void loadBuffer(const uint8_t* frame);
+  // Send a prebuilt frame straight to the panel, the framebuffer is left as is
+  // and marked dirty so the next displayDirty() brings it back
+  void displayBuffer(const uint8_t* frame);
 
   // Low-level procedures
   void reset();
   void dim(bool dim);
   void writeCommand(uint8_t data);
-  void writeData(uint8_t* buffer, size_t buff_size);
+  void writeData(const uint8_t* buffer, size_t buff_size);
 
-  void setCursor(uint8_t x, uint8_t y);
+  // Rotation in degrees (0, 90, 180, 270) or 90 degree steps (0-3), any other
+  // value is rejected and leaves the rotation as is. getRotation() returns steps.
+  bool setRotation(uint16_t degrees);
+  uint8_t getRotation() const { return Rotation; }
+  int16_t width() const { return Width; }
+  int16_t height() const { return Height; }
+
+  // Viewports translate the origin and clip all primitives, coordinates below are viewport relative
+  bool pushViewport(int16_t x, int16_t y, int16_t w, int16_t h, bool translate = true);
+  void popViewport();
+  void resetViewport();
+  bool clipToViewport(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+
+  void setCursor(int16_t x, int16_t y);
+  // Style (TextStyle flags) and integer scale 1..4 of writeChar/writeString,
+  // a glyph cell is then FontWidth * scale by FontHeight * scale pixels
+  void setTextStyle(uint8_t style, uint8_t scale = 1);
+  uint8_t getTextStyle() const { return TextFlags; }
+  uint8_t getTextScale() const { return TextScale; }
   char writeString(const char* str, FontDef Font, SSD1306_COLOR color);
   char writeChar(char ch, FontDef Font, SSD1306_COLOR color);
-  void drawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color);
-  void drawRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
-  void fillRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, SSD1306_COLOR color);
-  void drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color);
-  void drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR color);
-  void drawImage(uint8_t* img, uint8_t x, uint8_t y, uint8_t w, uint8_t h, SSD1306_COLOR color, SSD1306_COLOR bg);
+  void drawPixel(int16_t x, int16_t y, SSD1306_COLOR color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  // Fills take an optional 8x8 pattern (see SSD1306_PATTERN_CHECKER), only its
+  // set pixels are drawn. Lines take an optional dash mask (see SSD1306_LINE_DOTTED).
+  // Both are anchored to the framebuffer, so neighbouring shapes line up.
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color, const uint8_t* pattern = NULL);
+  void drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color, uint8_t dash = SSD1306_LINE_SOLID);
+  void drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR color, uint8_t dash = SSD1306_LINE_SOLID);
+  void drawImage(uint8_t* img, int16_t x, int16_t y, uint8_t w, uint8_t h, SSD1306_COLOR color, SSD1306_COLOR bg);
+  void drawBitmap(const uint8_t* pages, int16_t x, int16_t y, uint8_t w, uint8_t h, SSD1306_COLOR color);
+  // Fill the 4-connected area of pixels equal to the one at x, y, bounded by the
+  // viewport. `scratch` is an SSD1306_BUFFER_SIZE byte visited mask owned by
+  // the caller (an SSD1306_Framebuffer will do); the fill is exact with it
+  // even when the span stack overflows. Returns false without a scratch buffer.
+  bool floodFill(int16_t x, int16_t y, SSD1306_COLOR color, uint8_t* scratch, const uint8_t* pattern = NULL);
+  // Move the w x h area at x, y by dx, dy and fill the part of it that is left
+  // uncovered with `fill`. scrollRect() moves the content inside the area
+  // instead, what is pushed out of it is dropped. Both shift framebuffer bytes
+  // and leave marking the area dirty to the caller.
+  void moveRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, SSD1306_COLOR fill = SSD1306_BLACK);
+  void scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, SSD1306_COLOR fill = SSD1306_BLACK);
 
   void drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, SSD1306_COLOR color);
-  void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, SSD1306_COLOR color);
+  void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, SSD1306_COLOR color, const uint8_t* pattern = NULL);
   void drawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color);
-  void fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color, const uint8_t* pattern = NULL);
   void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, SSD1306_COLOR color);
   void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, SSD1306_COLOR color);
   void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color);
-  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color);
-  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color);
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color, const uint8_t* pattern = NULL);
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color, uint8_t dash = SSD1306_LINE_SOLID);
   void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color);
 
+  // Leaf primitives with the raster operation (SSD1306_ROP) fixed at compile
+  // time, nothing is decided per pixel. The color versions above pick one of
+  // these once per call. Composites take them through SSD1306_RopTarget.
+  template <uint8_t Op> void drawPixel(int16_t x, int16_t y);
+  template <uint8_t Op> void drawHLine(int16_t x, int16_t y, int16_t w);
+  template <uint8_t Op> void drawVLine(int16_t x, int16_t y, int16_t h);
+  template <uint8_t Op> void fillRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  // Patterned variants, one read-modify-write per page byte
+  template <uint8_t Op> void drawHLine(int16_t x, int16_t y, int16_t w, const uint8_t* pattern);
+  template <uint8_t Op> void drawVLine(int16_t x, int16_t y, int16_t h, const uint8_t* pattern);
+  template <uint8_t Op> void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* pattern);
+
+  // drawPixel() never toggles: SSD1306_INVERSE clears, and all colors flip on an
+  // inverted display. Lines and fills take the color as it is.
+  uint8_t pixelOp(SSD1306_COLOR color) const {
+    return (color == (Inverted ? SSD1306_BLACK : SSD1306_WHITE)) ? SSD1306_ROP_SET : SSD1306_ROP_CLEAR;
+  }
+
 private:
-  uint16_t CurrentX;
-  uint16_t CurrentY;
+  typedef struct {
+    int16_t OriginX, OriginY;  // translation applied to every coordinate
+    int16_t ClipX0, ClipY0;    // clip rectangle in buffer coordinates,
+    int16_t ClipX1, ClipY1;    // end exclusive
+  } Viewport;
+
+  int16_t CurrentX;
+  int16_t CurrentY;
+  uint8_t TextFlags;
+  uint8_t TextScale;
   uint8_t Inverted;
   uint8_t Initialized;
-  uint8_t SSD1306_Buffer[SSD1306_HEIGHT * SSD1306_WIDTH / 8];
+  uint8_t Rotation;
+  int16_t Width;   // logical width, swapped with height when rotated by 90/270
+  int16_t Height;
+  uint8_t* SSD1306_Buffer;  // bound framebuffer
+  uint8_t* DefaultBuffer;   // bound by setBuffer(NULL)
+#ifndef SSD1306_NO_DEFAULT_BUFFER
+  SSD1306_Framebuffer BuiltinBuffer;
+#endif
+  // Dirty column span per physical page, DirtyMin > DirtyMax when clean
+  uint8_t DirtyMin[SSD1306_HEIGHT / 8];
+  uint8_t DirtyMax[SSD1306_HEIGHT / 8];
+  // Incremental flush state
+  uint8_t FlushActive;
+  uint8_t FlushDirtyOnly;
+  uint8_t FlushPos;
+  uint32_t FrameSeq;
+  uint32_t ByteCost;  // learned cost of one byte on the bus, 1/256 us
   uint8_t vccstate = SSD1306_SWITCHCAPVCC;
+  Viewport View;
+  Viewport ViewStack[SSD1306_VIEWPORT_DEPTH];
+  uint8_t ViewDepth;
+
+  void transposePage(const uint8_t* src, uint8_t page, uint8_t* out);
+  void setColumn(uint8_t page, uint8_t column);
+  uint8_t flushPage(uint8_t page, bool dirtyOnly);
+  void startFrame(bool dirtyOnly);
+  void endFrame();
+  void clearDirty();
+  void markAllDirty();
+  void blitGlyph(const FontDef& Font, uint8_t code, SSD1306_COLOR color);
+  void copyArea(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy);
+  void fillExposed(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, SSD1306_COLOR fill);
+  uint8_t floodRows(int16_t x, int16_t page, uint8_t target, const uint8_t* visited) const;
+  void floodExtent(int16_t x, int16_t y, uint8_t target, const uint8_t* visited, int16_t& top, int16_t& bottom) const;
+  bool outsideClip(int16_t x, int16_t y, int16_t w, int16_t h) const;
+  bool triangleOutsideClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2) const;
 
   SPIClass* spi;
+  uint8_t OwnsBus;
   int8_t mosiPin;
   int8_t clkPin;
   int8_t dcPin;
   int8_t csPin;
   int8_t rstPin;
+  uint8_t HwCs;
+  uint8_t FastGpio;
+
+  // Cached GPIO set/clear registers, NULL where only digitalWrite() works
+  volatile uint32_t* csSet;
+  volatile uint32_t* csClr;
+  volatile uint32_t* dcSet;
+  volatile uint32_t* dcClr;
+  uint32_t csMask;
+  uint32_t dcMask;
+
+  void cachePin(int8_t pin, volatile uint32_t** set, volatile uint32_t** clr, uint32_t* mask);
+  inline void select();
+  inline void deselect();
+  inline void commandMode();
+  inline void dataMode();
 };
 
 #endif  // SSD1306_H
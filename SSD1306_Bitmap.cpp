@@ -0,0 +1,72 @@
+#include "SSD1306_Bitmap.h"
+
+void ssd1306_transpose8(const uint8_t* in, uint8_t* out) {
+  uint64_t x = 0, t;
+
+  for (uint8_t i = 0; i < 8; i++) x |= (uint64_t)in[i] << (i << 3);
+
+  // Swap 1x1, then 2x2, then 4x4 sub-blocks across the diagonal
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+
+  for (uint8_t j = 0; j < 8; j++) out[j] = (uint8_t)(x >> (j << 3));
+}
+
+size_t ssd1306_rowmajor_size(uint16_t w, uint16_t h) {
+  return (size_t)((w + 7) >> 3) * h;
+}
+
+size_t ssd1306_pages_size(uint16_t w, uint16_t h) {
+  return (size_t)((h + 7) >> 3) * w;
+}
+
+void ssd1306_rowmajor_to_pages(const uint8_t* img, uint16_t w, uint16_t h, uint8_t* pages) {
+  uint16_t bw = (w + 7) >> 3;  // Bitmask scanline pad = whole byte
+  uint8_t in[8], out[8];
+
+  for (uint16_t p = 0; p < ((h + 7) >> 3); p++) {
+    for (uint16_t b = 0; b < bw; b++) {
+      // Eight source rows of one byte column, zero past the last row
+      for (uint8_t i = 0; i < 8; i++) {
+        uint16_t row = (p << 3) + i;
+        in[i] = (row < h) ? img[row * bw + b] : 0;
+      }
+
+      ssd1306_transpose8(in, out);
+
+      // MSB is the leftmost pixel, so column j comes from bit 7 - j
+      for (uint8_t j = 0; j < 8; j++) {
+        uint16_t col = (b << 3) + j;
+        if (col >= w) break;
+        pages[p * w + col] = out[7 - j];
+      }
+    }
+  }
+}
+
+void ssd1306_pages_to_rowmajor(const uint8_t* pages, uint16_t w, uint16_t h, uint8_t* img) {
+  uint16_t bw = (w + 7) >> 3;
+  uint8_t in[8], out[8];
+
+  for (uint16_t p = 0; p < ((h + 7) >> 3); p++) {
+    for (uint16_t b = 0; b < bw; b++) {
+      // Columns in reverse so the leftmost one ends up in the MSB
+      for (uint8_t j = 0; j < 8; j++) {
+        uint16_t col = (b << 3) + j;
+        in[7 - j] = (col < w) ? pages[p * w + col] : 0;
+      }
+
+      ssd1306_transpose8(in, out);
+
+      for (uint8_t i = 0; i < 8; i++) {
+        uint16_t row = (p << 3) + i;
+        if (row >= h) break;
+        img[row * bw + b] = out[i];
+      }
+    }
+  }
+}
@@ -0,0 +1,31 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef __SSD1306_BITMAP_H__
+#define __SSD1306_BITMAP_H__
+
+// Conversion between the two bitmap layouts used with the SSD1306:
+//
+//  row-major: XBM-style rows of ((w + 7) / 8) bytes, MSB is the leftmost pixel
+//             (the format drawImage() reads)
+//  pages:     one byte per column per 8-row page, LSB is the top pixel
+//             (the framebuffer format, ((h + 7) / 8) * w bytes)
+//
+// Both directions work on 8x8 blocks with a SWAR bit-matrix transpose, so no
+// per-pixel work is done. This file has no Arduino dependencies and is shared
+// with the host-side converter in extras/tools.
+
+// Transpose an 8x8 bit matrix: bit j of in[i] becomes bit i of out[j]
+void ssd1306_transpose8(const uint8_t* in, uint8_t* out);
+
+// Size in bytes of a w x h bitmap in either layout
+size_t ssd1306_rowmajor_size(uint16_t w, uint16_t h);
+size_t ssd1306_pages_size(uint16_t w, uint16_t h);
+
+// Row-major (MSB first) to page format, e.g. at load time for drawBitmap()
+void ssd1306_rowmajor_to_pages(const uint8_t* img, uint16_t w, uint16_t h, uint8_t* pages);
+
+// Page format to row-major (MSB first), e.g. to snapshot the framebuffer
+void ssd1306_pages_to_rowmajor(const uint8_t* pages, uint16_t w, uint16_t h, uint8_t* img);
+
+#endif  // __SSD1306_BITMAP_H__
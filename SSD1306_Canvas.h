@@ -0,0 +1,128 @@
+#ifndef SSD1306_CANVAS_H
+#define SSD1306_CANVAS_H
+
+#include "SSD1306_Raster.h"
+#include "SSD1306_FontData.h"
+
+// Framebuffer in the panel's page format that can be drawn while compiling.
+// With C++14 a static screen (splash, menu frame, fixed labels) is baked into
+// a constexpr canvas and lands in flash, ready for SSD1306::loadBuffer() or
+// SSD1306::displayBuffer(); nothing is rasterized at runtime:
+//
+//   constexpr SSD1306_Canvas<> splashScreen() {
+//     SSD1306_Canvas<> c;
+//     c.drawRoundRect(0, 0, 128, 64, 6, SSD1306_WHITE);
+//     c.writeString(18, 22, "Booting", ConstFont_11x18, SSD1306_WHITE);
+//     return c;
+//   }
+//   static constexpr SSD1306_Canvas<> Splash = splashScreen();
+//   ...
+//   oled.displayBuffer(Splash.Buffer);
+//
+// Primitives produce the same pixels as their SSD1306 counterparts. Use
+// W = SSD1306_HEIGHT, H = SSD1306_WIDTH for screens shown at 90/270 degrees.
+// Fonts must be constexpr too, use the ConstFont_* definitions.
+template <int16_t W = SSD1306_WIDTH, int16_t H = SSD1306_HEIGHT>
+class SSD1306_Canvas {
+public:
+  uint8_t Buffer[W * H / 8];
+
+  SSD1306_CONSTEXPR SSD1306_Canvas() : Buffer() {}
+
+  SSD1306_CONSTEXPR int16_t width() const { return W; }
+  SSD1306_CONSTEXPR int16_t height() const { return H; }
+
+  SSD1306_CONSTEXPR void clear(SSD1306_COLOR color = SSD1306_BLACK) {
+    for (uint16_t i = 0; i < sizeof(Buffer); i++) Buffer[i] = (color == SSD1306_BLACK) ? 0x00 : 0xFF;
+  }
+
+  SSD1306_CONSTEXPR void drawPixel(int16_t x, int16_t y, SSD1306_COLOR color) {
+    if (x < 0 || x >= W || y < 0 || y >= H) return;
+
+    if (color == SSD1306_WHITE) {
+      Buffer[x + (y / 8) * W] |= (1 << (y & 7));
+    } else {
+      Buffer[x + (y / 8) * W] &= ~(1 << (y & 7));
+    }
+  }
+
+  SSD1306_CONSTEXPR void drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color) {
+    for (int16_t i = 0; i < w; i++) writePixel(x + i, y, color);
+  }
+
+  SSD1306_CONSTEXPR void drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR color) {
+    for (int16_t i = 0; i < h; i++) writePixel(x, y + i, color);
+  }
+
+  SSD1306_CONSTEXPR void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color) {
+    for (int16_t j = 0; j < h; j++) drawHLine(x, y + j, w, color);
+  }
+
+  SSD1306_CONSTEXPR void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color = SSD1306_WHITE) {
+    SSD1306_Raster::drawRect(*this, x, y, w, h, color);
+  }
+
+  SSD1306_CONSTEXPR void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+    SSD1306_Raster::drawRoundRect(*this, x, y, w, h, r, color);
+  }
+
+  SSD1306_CONSTEXPR void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+    SSD1306_Raster::fillRoundRect(*this, x, y, w, h, r, color);
+  }
+
+  SSD1306_CONSTEXPR void drawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+    SSD1306_Raster::drawCircle(*this, x0, y0, r, color);
+  }
+
+  SSD1306_CONSTEXPR void fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+    SSD1306_Raster::fillCircle(*this, x0, y0, r, color);
+  }
+
+  SSD1306_CONSTEXPR void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
+    SSD1306_Raster::drawTriangle(*this, x0, y0, x1, y1, x2, y2, color);
+  }
+
+  SSD1306_CONSTEXPR void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
+    SSD1306_Raster::fillTriangle(*this, x0, y0, x1, y1, x2, y2, color);
+  }
+
+  SSD1306_CONSTEXPR void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
+    SSD1306_Raster::drawLine(*this, x0, y0, x1, y1, color);
+  }
+
+  // Same rules as SSD1306::writeChar(): invalid characters and glyphs that do
+  // not fit on the canvas are skipped. Returns the x after the glyph.
+  SSD1306_CONSTEXPR int16_t writeChar(int16_t x, int16_t y, char ch, const FontDef& Font, SSD1306_COLOR color) {
+    uint8_t code = SSD1306_Raster::glyphCode(ch, Font);
+    if (!code || W < x + Font.FontWidth || H < y + Font.FontHeight) return x;
+
+    SSD1306_Raster::drawGlyph(*this, *this, x, y, code, Font, color);
+    return x + Font.FontWidth;
+  }
+
+  // Stops at the first character that can not be written, like SSD1306::writeString()
+  SSD1306_CONSTEXPR int16_t writeString(int16_t x, int16_t y, const char* str, const FontDef& Font, SSD1306_COLOR color) {
+    while (*str) {
+      int16_t next = writeChar(x, y, *str, Font, color);
+      if (next == x) break;
+      x = next;
+      str++;
+    }
+    return x;
+  }
+
+private:
+  // Line pixels honour SSD1306_INVERSE like drawHLine/drawVLine on the panel
+  SSD1306_CONSTEXPR void writePixel(int16_t x, int16_t y, SSD1306_COLOR color) {
+    if (x < 0 || x >= W || y < 0 || y >= H) return;
+
+    uint8_t mask = 1 << (y & 7);
+    switch (color) {
+      case SSD1306_WHITE: Buffer[x + (y / 8) * W] |= mask; break;
+      case SSD1306_BLACK: Buffer[x + (y / 8) * W] &= ~mask; break;
+      case SSD1306_INVERSE: Buffer[x + (y / 8) * W] ^= mask; break;
+    }
+  }
+};
+
+#endif  // SSD1306_CANVAS_H
@@ -0,0 +1,102 @@
+#include <cstring>
+#include "SSD1306_NumericField.h"
+
+SSD1306_NumericField::SSD1306_NumericField(int16_t x, int16_t y, uint8_t width, const FontDef& Font, uint8_t decimals, uint8_t flags) {
+  this->X = x;
+  this->Y = y;
+  this->Len = (width > SSD1306_FIELD_LEN) ? SSD1306_FIELD_LEN : width;
+  this->Decimals = decimals;
+  this->Flags = flags;
+  this->Font = &Font;
+  this->Value = 0;
+  format(0, Len, Decimals, Flags, Text);
+  invalidate();
+}
+
+void SSD1306_NumericField::setValue(int32_t value) {
+  if (value == this->Value) return;
+
+  this->Value = value;
+  format(value, Len, Decimals, Flags, Text);
+}
+
+void SSD1306_NumericField::invalidate() {
+  // No character matches a null-byte, so every cell differs
+  memset(Shown, 0, sizeof(Shown));
+}
+
+uint8_t SSD1306_NumericField::draw(SSD1306& oled, SSD1306_COLOR color) {
+  return drawCells(oled, X, Y, *Font, Text, Shown, Len, color);
+}
+
+uint8_t SSD1306_NumericField::drawCells(SSD1306& oled, int16_t x, int16_t y, const FontDef& Font, const char* text,
+                                        char* shown, uint8_t len, SSD1306_COLOR color) {
+  uint8_t drawn = 0;
+  uint8_t style = oled.getTextStyle();
+  uint8_t scale = oled.getTextScale();
+  int16_t cellW = Font.FontWidth * scale;
+  int16_t cellH = Font.FontHeight * scale;
+
+  // Each cell must erase the old glyph, keep the caller's scale and bold
+  oled.setTextStyle(style & ~TEXT_TRANSPARENT, scale);
+
+  for (uint8_t i = 0; i < len; i++) {
+    if (text[i] == shown[i]) continue;
+
+    int16_t cx = x + i * cellW;
+    oled.setCursor(cx, y);
+    oled.writeChar(text[i], Font, color);
+    oled.markDirty(cx, y, cellW, cellH);
+
+    shown[i] = text[i];
+    drawn++;
+  }
+
+  oled.setTextStyle(style, scale);
+  return drawn;
+}
+
+void SSD1306_NumericField::format(int32_t value, uint8_t width, uint8_t decimals, uint8_t flags, char* out) {
+  char digits[12];  // 10 digits of uint32_t, plus room for leading "0." zeros
+  uint8_t n = 0;
+  bool negative = value < 0;
+  uint32_t v = negative ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+
+  // Digits in reverse order, at least one before the decimal point
+  do {
+    digits[n++] = '0' + (v % 10);
+    v /= 10;
+  } while (v && n < sizeof(digits));
+  while (n <= decimals && n < sizeof(digits)) digits[n++] = '0';
+
+  char sign = negative ? '-' : ((flags & FIELD_FORCE_SIGN) ? '+' : 0);
+  uint8_t needed = n + (decimals ? 1 : 0) + (sign ? 1 : 0);
+
+  if (needed > width) {
+    memset(out, '#', width);
+    out[width] = 0;
+    return;
+  }
+
+  uint8_t pad = width - needed;
+  uint8_t pos = 0;
+
+  if (flags & FIELD_PAD_ZERO) {
+    // Sign goes before the zeros: "-0042"
+    if (sign) out[pos++] = sign;
+    while (pad--) out[pos++] = '0';
+  } else {
+    if (!(flags & FIELD_ALIGN_LEFT))
+      while (pad--) out[pos++] = ' ';
+    if (sign) out[pos++] = sign;
+  }
+
+  while (n) {
+    if (n == decimals) out[pos++] = '.';
+    out[pos++] = digits[--n];
+  }
+
+  // Right padding for left aligned fields
+  while (pos < width) out[pos++] = ' ';
+  out[width] = 0;
+}
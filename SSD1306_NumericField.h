@@ -0,0 +1,55 @@
+#ifndef SSD1306_NUMERICFIELD_H
+#define SSD1306_NUMERICFIELD_H
+
+#include "SSD1306.h"
+
+// Maximum number of characters in a field
+#ifndef SSD1306_FIELD_LEN
+#define SSD1306_FIELD_LEN 12
+#endif
+
+enum FieldFlags {
+  FIELD_PAD_ZERO = 0x01,    // pad with leading zeros instead of spaces
+  FIELD_FORCE_SIGN = 0x02,  // print '+' for positive values
+  FIELD_ALIGN_LEFT = 0x04   // pad on the right
+};
+
+// Fixed-width number on screen that formats without printf and only redraws
+// the glyph cells whose character changed since the last draw(). Fixed-point
+// values are passed as integers scaled by 10^decimals, e.g. 2375 with two
+// decimals shows "23.75". Values that do not fit are shown as '#'.
+class SSD1306_NumericField {
+public:
+  SSD1306_NumericField(int16_t x, int16_t y, uint8_t width, const FontDef& Font, uint8_t decimals = 0, uint8_t flags = 0);
+
+  void setValue(int32_t value);
+  int32_t getValue() const { return Value; }
+
+  // Redraw the changed cells and mark them dirty, returns the number of cells drawn.
+  // Cells follow the oled's text scale, clear the area and invalidate() after changing it.
+  uint8_t draw(SSD1306& oled, SSD1306_COLOR color = SSD1306_WHITE);
+  // Force a full redraw on the next draw()
+  void invalidate();
+
+  // Format `value` into `out` (exactly `width` chars plus null-byte)
+  static void format(int32_t value, uint8_t width, uint8_t decimals, uint8_t flags, char* out);
+  // Draw the cells of `text` that differ from `shown` at (x, y), mark them
+  // dirty and update `shown`, returns the number of cells drawn. Cells are
+  // FontWidth x FontHeight times the current text scale and always drawn
+  // opaque, the text style is restored afterwards.
+  static uint8_t drawCells(SSD1306& oled, int16_t x, int16_t y, const FontDef& Font, const char* text, char* shown,
+                           uint8_t len, SSD1306_COLOR color);
+
+private:
+  int16_t X;
+  int16_t Y;
+  uint8_t Len;
+  uint8_t Decimals;
+  uint8_t Flags;
+  const FontDef* Font;
+  int32_t Value;
+  char Text[SSD1306_FIELD_LEN + 1];
+  char Shown[SSD1306_FIELD_LEN + 1];
+};
+
+#endif  // SSD1306_NUMERICFIELD_H
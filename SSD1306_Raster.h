@@ -0,0 +1,406 @@
+#ifndef SSD1306_RASTER_H
+#define SSD1306_RASTER_H
+
+#include "SSD1306.h"
+
+// Rasterization is constexpr from C++14 on, so a static screen can be drawn
+// into an SSD1306_Canvas while compiling. C++11 builds still get the same code
+// at runtime.
+#if __cplusplus >= 201402L
+#define SSD1306_CONSTEXPR constexpr
+#else
+#define SSD1306_CONSTEXPR
+#endif
+
+#ifndef swap16
+#define swap16(a, b) \
+  { \
+    int16_t t = a; \
+    a = b; \
+    b = t; \
+  }
+#endif
+
+// Composite primitives and glyph rendering, shared by SSD1306 and
+// SSD1306_Canvas. The target only has to provide drawPixel, drawHLine,
+// drawVLine and fillRect; clipping is the target's job.
+struct SSD1306_Raster {
+  static SSD1306_CONSTEXPR int16_t iabs(int16_t v) {
+    return v < 0 ? -v : v;
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void drawRect(T& dst, int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color) {
+    if (w <= 0 || h <= 0) return;
+
+    dst.drawHLine(x, y, w, color);
+    dst.drawHLine(x, y + h - 1, w, color);
+    dst.drawVLine(x, y, h, color);
+    dst.drawVLine(x + w - 1, y, h, color);
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void drawRoundRect(T& dst, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+    int16_t max_radius = ((w < h) ? w : h) / 2;  // 1/2 minor axis
+    if (r > max_radius)
+      r = max_radius;
+    // smarter version
+    dst.drawHLine(x + r, y, w - 2 * r, color);          // Top
+    dst.drawHLine(x + r, y + h - 1, w - 2 * r, color);  // Bottom
+    dst.drawVLine(x, y + r, h - 2 * r, color);          // Left
+    dst.drawVLine(x + w - 1, y + r, h - 2 * r, color);  // Right
+    // draw four corners
+    drawCircleHelper(dst, x + r, y + r, r, 1, color);
+    drawCircleHelper(dst, x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(dst, x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(dst, x + r, y + h - r - 1, r, 8, color);
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void fillRoundRect(T& dst, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+    int16_t max_radius = ((w < h) ? w : h) / 2; // 1/2 minor axis
+    if (r > max_radius)
+      r = max_radius;
+    // smarter version
+    dst.fillRect(x + r, y, w - 2 * r, h, color);
+    // draw four corners
+    fillCircleHelper(dst, x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    fillCircleHelper(dst, x + r, y + r, r, 2, h - 2 * r - 1, color);
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void drawCircle(T& dst, int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    dst.drawPixel(x0, y0 + r, color);
+    dst.drawPixel(x0, y0 - r, color);
+    dst.drawPixel(x0 + r, y0, color);
+    dst.drawPixel(x0 - r, y0, color);
+
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+
+      dst.drawPixel(x0 + x, y0 + y, color);
+      dst.drawPixel(x0 - x, y0 + y, color);
+      dst.drawPixel(x0 + x, y0 - y, color);
+      dst.drawPixel(x0 - x, y0 - y, color);
+      dst.drawPixel(x0 + y, y0 + x, color);
+      dst.drawPixel(x0 - y, y0 + x, color);
+      dst.drawPixel(x0 + y, y0 - x, color);
+      dst.drawPixel(x0 - y, y0 - x, color);
+    }
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void fillCircle(T& dst, int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+    dst.drawVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(dst, x0, y0, r, 3, 0, color);
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void drawCircleHelper(T& dst, int16_t x0, int16_t y0, int16_t r, uint8_t cornername, SSD1306_COLOR color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (cornername & 0x4) {
+        dst.drawPixel(x0 + x, y0 + y, color);
+        dst.drawPixel(x0 + y, y0 + x, color);
+      }
+      if (cornername & 0x2) {
+        dst.drawPixel(x0 + x, y0 - y, color);
+        dst.drawPixel(x0 + y, y0 - x, color);
+      }
+      if (cornername & 0x8) {
+        dst.drawPixel(x0 - y, y0 + x, color);
+        dst.drawPixel(x0 - x, y0 + y, color);
+      }
+      if (cornername & 0x1) {
+        dst.drawPixel(x0 - y, y0 - x, color);
+        dst.drawPixel(x0 - x, y0 - y, color);
+      }
+    }
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void fillCircleHelper(T& dst, int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, SSD1306_COLOR color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    int16_t px = x;
+    int16_t py = y;
+
+    delta++; // Avoid some +1's in the loop
+
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      // These checks avoid double-drawing certain lines, important
+      // for the SSD1306 library which has an INVERT drawing mode.
+      if (x < (y + 1)) {
+        if (corners & 1)
+          dst.drawVLine(x0 + x, y0 - y, 2 * y + delta, color);
+        if (corners & 2)
+          dst.drawVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+      if (y != py) {
+        if (corners & 1)
+          dst.drawVLine(x0 + py, y0 - px, 2 * px + delta, color);
+        if (corners & 2)
+          dst.drawVLine(x0 - py, y0 - px, 2 * px + delta, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void drawTriangle(T& dst, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
+    drawLine(dst, x0, y0, x1, y1, color);
+    drawLine(dst, x1, y1, x2, y2, color);
+    drawLine(dst, x2, y2, x0, y0, color);
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void fillTriangle(T& dst, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, SSD1306_COLOR color) {
+    int16_t a = 0, b = 0, y = 0, last = 0;
+
+    // Sort coordinates by Y order (y2 >= y1 >= y0)
+    if (y0 > y1) {
+      swap16(y0, y1);
+      swap16(x0, x1);
+    }
+    if (y1 > y2) {
+      swap16(y2, y1);
+      swap16(x2, x1);
+    }
+    if (y0 > y1) {
+      swap16(y0, y1);
+      swap16(x0, x1);
+    }
+
+    if (y0 == y2) { // Handle awkward all-on-same-line case as its own thing
+      a = b = x0;
+      if (x1 < a)
+        a = x1;
+      else if (x1 > b)
+        b = x1;
+      if (x2 < a)
+        a = x2;
+      else if (x2 > b)
+        b = x2;
+      dst.drawHLine(a, y0, b - a + 1, color);
+      return;
+    }
+
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0,
+            dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+
+    // For upper part of triangle, find scanline crossings for segments
+    // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
+    // is included here (and second loop will be skipped, avoiding a /0
+    // error there), otherwise scanline y1 is skipped here and handled
+    // in the second loop...which also avoids a /0 error here if y0=y1
+    // (flat-topped triangle).
+    if (y1 == y2)
+      last = y1; // Include y1 scanline
+    else
+      last = y1 - 1; // Skip it
+
+    for (y = y0; y <= last; y++) {
+      a = x0 + sa / dy01;
+      b = x0 + sb / dy02;
+      sa += dx01;
+      sb += dx02;
+      /* longhand:
+      a = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+      b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+      */
+      if (a > b)
+        swap16(a, b);
+      dst.drawHLine(a, y, b - a + 1, color);
+    }
+
+    // For lower part of triangle, find scanline crossings for segments
+    // 0-2 and 1-2.  This loop is skipped if y1=y2.
+    sa = (int32_t)dx12 * (y - y1);
+    sb = (int32_t)dx02 * (y - y0);
+    for (; y <= y2; y++) {
+      a = x1 + sa / dy12;
+      b = x0 + sb / dy02;
+      sa += dx12;
+      sb += dx02;
+      /* longhand:
+      a = x1 + (x2 - x1) * (y - y1) / (y2 - y1);
+      b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+      */
+      if (a > b)
+        swap16(a, b);
+      dst.drawHLine(a, y, b - a + 1, color);
+    }
+
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void drawLine(T& dst, int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
+    // Update in subclasses if desired!
+    if (x0 == x1) {
+      if (y0 > y1)
+        swap16(y0, y1);
+      dst.drawVLine(x0, y0, y1 - y0 + 1, color);
+    } else if (y0 == y1) {
+      if (x0 > x1)
+        swap16(x0, x1);
+      dst.drawHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+      writeLine(dst, x0, y0, x1, y1, color);
+    }
+  }
+
+  template <class T>
+  static SSD1306_CONSTEXPR void writeLine(T& dst, int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
+    int16_t steep = iabs(y1 - y0) > iabs(x1 - x0);
+    if (steep) {
+      swap16(x0, y0);
+      swap16(x1, y1);
+    }
+
+    if (x0 > x1) {
+      swap16(x0, x1);
+      swap16(y0, y1);
+    }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = iabs(y1 - y0);
+
+    int16_t err = dx / 2;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+
+    for (; x0 <= x1; x0++) {
+      if (steep) {
+        dst.drawPixel(y0, x0, color);
+      } else {
+        dst.drawPixel(x0, y0, color);
+      }
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  // Glyph index of `ch` in the font table, 0 if the character is not valid.
+  // Characters above 126 only exist in the 7x10 font.
+  static SSD1306_CONSTEXPR uint8_t glyphCode(char ch, const FontDef& Font) {
+    if (ch < 32) return 0;
+    if (ch > 126) {
+      if (Font.FontHeight != 10 && Font.FontWidth != 7) return 0;
+
+      switch ((uint8_t)ch) {
+        case 199: return 127;
+        case 208: return 128;
+        case 214: return 129;
+        case 218: return 130;
+        case 220: return 131;
+        case 222: return 132;
+        case 231: return 133;
+
+        case 240: return 134;
+        case 243: return 135;
+        case 246: return 136;
+        case 250: return 137;
+        case 252: return 138;
+        case 253: return 139;
+        case 254: return 140;
+      }
+    }
+    return (uint8_t)ch;
+  }
+
+  // Draw glyph `code` (see glyphCode) with its top-left corner at x, y.
+  // Set pixels go to `dst` in `color`, the rest of the cell to `bg` in the
+  // opposite color; usually both are the same target.
+  template <class T, class B>
+  static SSD1306_CONSTEXPR void drawGlyph(T& dst, B& bg, int16_t x, int16_t y, uint8_t code, const FontDef& Font, SSD1306_COLOR color) {
+    for (uint8_t i = 0; i < Font.FontHeight; i++) {
+      uint32_t b = Font.data[(code - 32) * Font.FontHeight + i];
+      for (uint8_t j = 0; j < Font.FontWidth; j++) {
+        if ((b << j) & 0x8000) {
+          dst.drawPixel(x + j, y + i, color);
+        } else {
+          bg.drawPixel(x + j, y + i, (SSD1306_COLOR)!color);
+        }
+      }
+    }
+  }
+};
+
+// SSD1306_Raster target drawing into an SSD1306 with compile-time raster
+// operations, the color arguments are ignored. Pixels use PixelOp, lines and
+// fills LineOp, matching how the color API treats them (see SSD1306::pixelOp()).
+//   SSD1306_RopTarget<SSD1306_ROP_INVERSE> dst(oled);
+//   SSD1306_Raster::fillCircle(dst, 64, 32, 10, SSD1306_WHITE);
+template <uint8_t PixelOp, uint8_t LineOp = PixelOp>
+class SSD1306_RopTarget {
+public:
+  explicit SSD1306_RopTarget(SSD1306& oled) : Oled(oled) {}
+
+  void drawPixel(int16_t x, int16_t y, SSD1306_COLOR) { Oled.template drawPixel<PixelOp>(x, y); }
+  void drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR) { Oled.template drawHLine<LineOp>(x, y, w); }
+  void drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR) { Oled.template drawVLine<LineOp>(x, y, h); }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR) { Oled.template fillRect<LineOp>(x, y, w, h); }
+
+private:
+  SSD1306& Oled;
+};
+
+// Like SSD1306_RopTarget, but every primitive only touches the pixels that
+// are set in an 8x8 pattern (SSD1306_PATTERN_*) anchored to the framebuffer
+template <uint8_t Op>
+class SSD1306_PatternTarget {
+public:
+  SSD1306_PatternTarget(SSD1306& oled, const uint8_t* pattern) : Oled(oled), Pattern(pattern) {}
+
+  void drawPixel(int16_t x, int16_t y, SSD1306_COLOR) { Oled.template drawHLine<Op>(x, y, 1, Pattern); }
+  void drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR) { Oled.template drawHLine<Op>(x, y, w, Pattern); }
+  void drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR) { Oled.template drawVLine<Op>(x, y, h, Pattern); }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR) { Oled.template fillRect<Op>(x, y, w, h, Pattern); }
+
+private:
+  SSD1306& Oled;
+  const uint8_t* Pattern;
+};
+
+#endif  // SSD1306_RASTER_H
@@ -0,0 +1,42 @@
+#include "SSD1306_Remote.h"
+
+SSD1306_Remote::SSD1306_Remote() {
+  this->Oled = NULL;
+}
+
+void SSD1306_Remote::begin(SSD1306& oled) {
+  this->Oled = &oled;
+  oled.resetViewport();
+  Decoder.begin(oled.getBuffer(), oled.width(), oled.height() >> 3, onRun, this);
+}
+
+void SSD1306_Remote::onRun(void* ctx, uint8_t page, uint8_t column, uint8_t length) {
+  SSD1306_Remote* remote = (SSD1306_Remote*)ctx;
+  remote->Oled->markDirty(column, page * 8, length, 8);
+}
+
+int8_t SSD1306_Remote::feedByte(uint8_t b) {
+  int8_t r = Decoder.feed(b);
+
+  if (r == SSD1306_StreamDecoder::FRAME) Oled->displayDirty();
+  return r;
+}
+
+int8_t SSD1306_Remote::poll(Stream& in) {
+  while (in.available() > 0) {
+    int8_t r = feedByte((uint8_t)in.read());
+    // Hand control back after every frame
+    if (r != SSD1306_StreamDecoder::NONE) return r;
+  }
+  return SSD1306_StreamDecoder::NONE;
+}
+
+int8_t SSD1306_Remote::feed(const uint8_t* data, size_t n) {
+  int8_t result = SSD1306_StreamDecoder::NONE;
+
+  while (n--) {
+    int8_t r = feedByte(*data++);
+    if (r != SSD1306_StreamDecoder::NONE) result = r;
+  }
+  return result;
+}
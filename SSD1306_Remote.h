@@ -0,0 +1,36 @@
+#ifndef SSD1306_REMOTE_H
+#define SSD1306_REMOTE_H
+
+#include <Arduino.h>
+#include "SSD1306.h"
+#include "SSD1306_Stream.h"
+
+// Remote framebuffer mode: frames encoded with ssd1306_stream_encode() (see
+// extras/tools/fbstream) arrive over a Stream such as Serial, are decoded
+// straight into the bound framebuffer and flushed with displayDirty(), so only
+// the spans that changed are sent to the panel. The viewport is reset by begin(),
+// call it again after binding another framebuffer with setBuffer().
+class SSD1306_Remote {
+public:
+  SSD1306_Remote();
+  void begin(SSD1306& oled);
+
+  // Decode the bytes available on `in`, returns SSD1306_StreamDecoder::FRAME
+  // after a frame has been completed and flushed, ERROR on a bad frame and
+  // DROPPED for a delta ignored until the next keyframe
+  int8_t poll(Stream& in);
+  int8_t feed(const uint8_t* data, size_t n);
+
+  uint32_t frames() const { return Decoder.frames(); }
+  uint32_t errors() const { return Decoder.errors(); }
+  uint32_t dropped() const { return Decoder.dropped(); }
+
+private:
+  int8_t feedByte(uint8_t b);
+  static void onRun(void* ctx, uint8_t page, uint8_t column, uint8_t length);
+
+  SSD1306* Oled;
+  SSD1306_StreamDecoder Decoder;
+};
+
+#endif  // SSD1306_REMOTE_H
@@ -0,0 +1,291 @@
+#include <cstring>
+#include <Arduino.h>
+#include "SSD1306_RenderQueue.h"
+
+#if (SSD1306_QUEUE_DEPTH & (SSD1306_QUEUE_DEPTH - 1)) != 0
+#error "SSD1306_QUEUE_DEPTH must be a power of two"
+#endif
+
+SSD1306_DrawBatch::SSD1306_DrawBatch() {
+  reset();
+}
+
+void SSD1306_DrawBatch::reset() {
+  this->count = 0;
+  this->Flush = 1;
+}
+
+DrawCommand* SSD1306_DrawBatch::next(uint8_t op, uint8_t color) {
+  if (count >= SSD1306_BATCH_SIZE) return NULL;
+
+  DrawCommand* cmd = &cmds[count++];
+  cmd->op = op;
+  cmd->color = color;
+  return cmd;
+}
+
+bool SSD1306_DrawBatch::clear(SSD1306_COLOR color) {
+  return next(DRAW_CLEAR, color) != NULL;
+}
+
+bool SSD1306_DrawBatch::drawPixel(int16_t x, int16_t y, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_PIXEL, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  return true;
+}
+
+bool SSD1306_DrawBatch::drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_HLINE, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->x1 = w;
+  return true;
+}
+
+bool SSD1306_DrawBatch::drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_VLINE, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->y1 = h;
+  return true;
+}
+
+bool SSD1306_DrawBatch::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_LINE, color);
+  if (!cmd) return false;
+  cmd->x0 = x0;
+  cmd->y0 = y0;
+  cmd->x1 = x1;
+  cmd->y1 = y1;
+  return true;
+}
+
+bool SSD1306_DrawBatch::drawRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  DrawCommand* cmd = next(DRAW_RECT, SSD1306_WHITE);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->x1 = w;
+  cmd->y1 = h;
+  return true;
+}
+
+bool SSD1306_DrawBatch::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(FILL_RECT, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->x1 = w;
+  cmd->y1 = h;
+  return true;
+}
+
+bool SSD1306_DrawBatch::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_ROUNDRECT, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->x1 = w;
+  cmd->y1 = h;
+  cmd->r = r;
+  return true;
+}
+
+bool SSD1306_DrawBatch::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(FILL_ROUNDRECT, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->x1 = w;
+  cmd->y1 = h;
+  cmd->r = r;
+  return true;
+}
+
+bool SSD1306_DrawBatch::drawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_CIRCLE, color);
+  if (!cmd) return false;
+  cmd->x0 = x0;
+  cmd->y0 = y0;
+  cmd->r = r;
+  return true;
+}
+
+bool SSD1306_DrawBatch::fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(FILL_CIRCLE, color);
+  if (!cmd) return false;
+  cmd->x0 = x0;
+  cmd->y0 = y0;
+  cmd->r = r;
+  return true;
+}
+
+bool SSD1306_DrawBatch::writeString(int16_t x, int16_t y, const char* str, const FontDef& Font, SSD1306_COLOR color) {
+  DrawCommand* cmd = next(DRAW_STRING, color);
+  if (!cmd) return false;
+  cmd->x0 = x;
+  cmd->y0 = y;
+  cmd->font = &Font;
+  strncpy(cmd->text, str, SSD1306_TEXT_LEN - 1);
+  cmd->text[SSD1306_TEXT_LEN - 1] = 0;
+  return true;
+}
+
+void SSD1306_DrawBatch::apply(SSD1306& oled) const {
+  for (uint8_t i = 0; i < count; i++) {
+    const DrawCommand* cmd = &cmds[i];
+    SSD1306_COLOR color = (SSD1306_COLOR)cmd->color;
+
+    switch (cmd->op) {
+      case DRAW_CLEAR: oled.clear(color); break;
+      case DRAW_PIXEL: oled.drawPixel(cmd->x0, cmd->y0, color); break;
+      case DRAW_HLINE: oled.drawHLine(cmd->x0, cmd->y0, cmd->x1, color); break;
+      case DRAW_VLINE: oled.drawVLine(cmd->x0, cmd->y0, cmd->y1, color); break;
+      case DRAW_LINE: oled.drawLine(cmd->x0, cmd->y0, cmd->x1, cmd->y1, color); break;
+      case DRAW_RECT: oled.drawRect(cmd->x0, cmd->y0, cmd->x1, cmd->y1); break;
+      case FILL_RECT: oled.fillRect(cmd->x0, cmd->y0, cmd->x1, cmd->y1, color); break;
+      case DRAW_ROUNDRECT: oled.drawRoundRect(cmd->x0, cmd->y0, cmd->x1, cmd->y1, cmd->r, color); break;
+      case FILL_ROUNDRECT: oled.fillRoundRect(cmd->x0, cmd->y0, cmd->x1, cmd->y1, cmd->r, color); break;
+      case DRAW_CIRCLE: oled.drawCircle(cmd->x0, cmd->y0, cmd->r, color); break;
+      case FILL_CIRCLE: oled.fillCircle(cmd->x0, cmd->y0, cmd->r, color); break;
+      case DRAW_STRING:
+        oled.setCursor(cmd->x0, cmd->y0);
+        oled.writeString(cmd->text, *cmd->font, color);
+        break;
+    }
+  }
+}
+
+SSD1306_RenderQueue::SSD1306_RenderQueue()
+  : head(0), tail(0), droppedCount(0) {
+  // Slot i is free for the producer that claims position i
+  for (uint32_t i = 0; i < SSD1306_QUEUE_DEPTH; i++)
+    slots[i].seq.store(i, std::memory_order_relaxed);
+#if defined(ESP32)
+  task.store(NULL, std::memory_order_relaxed);
+  notifying.store(0, std::memory_order_relaxed);
+  stopping.store(false, std::memory_order_relaxed);
+  stopped = NULL;
+  target = NULL;
+#endif
+}
+
+bool SSD1306_RenderQueue::post(const SSD1306_DrawBatch& batch) {
+  uint32_t pos = head.load(std::memory_order_relaxed);
+  Slot* slot;
+
+  // Claim a slot: its sequence equals our position when it is free for us
+  for (;;) {
+    slot = &slots[pos & (SSD1306_QUEUE_DEPTH - 1)];
+    uint32_t seq = slot->seq.load(std::memory_order_acquire);
+    int32_t diff = (int32_t)(seq - pos);
+
+    if (diff == 0) {
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // Consumer has not released this slot yet, the queue is full
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Only the used part of the batch is copied
+  slot->batch.count = batch.count;
+  slot->batch.Flush = batch.Flush;
+  memcpy(slot->batch.cmds, batch.cmds, batch.count * sizeof(DrawCommand));
+
+  // Publish to the consumer
+  slot->seq.store(pos + 1, std::memory_order_release);
+
+#if defined(ESP32)
+  // stopTask() waits for `notifying` to drop before the handle goes stale.
+  // Sequentially consistent, pairs with the exchange and load in stopTask().
+  notifying.fetch_add(1);
+  TaskHandle_t t = task.load();
+  if (t) xTaskNotifyGive(t);
+  notifying.fetch_sub(1, std::memory_order_release);
+#endif
+  return true;
+}
+
+uint16_t SSD1306_RenderQueue::process(SSD1306& oled) {
+  uint16_t applied = 0;
+  bool flush = false;
+
+  for (;;) {
+    Slot* slot = &slots[tail & (SSD1306_QUEUE_DEPTH - 1)];
+    if (slot->seq.load(std::memory_order_acquire) != tail + 1) break;
+
+    slot->batch.apply(oled);
+    if (slot->batch.Flush) flush = true;
+
+    // Hand the slot back to producers for the next lap around the ring
+    slot->seq.store(tail + SSD1306_QUEUE_DEPTH, std::memory_order_release);
+    tail++;
+    applied++;
+  }
+
+  // Flush only between batches so no frame is ever torn
+  if (flush) oled.display();
+
+  return applied;
+}
+
+#if defined(ESP32)
+void SSD1306_RenderQueue::renderTask(void* arg) {
+  SSD1306_RenderQueue* queue = (SSD1306_RenderQueue*)arg;
+
+  // Batches posted before startTask() published the handle did not notify
+  for (;;) {
+    queue->process(*queue->target);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (queue->stopping.load(std::memory_order_acquire)) break;
+  }
+
+  // Only exit between batches, stopTask() is waiting for this
+  xSemaphoreGive(queue->stopped);
+  vTaskDelete(NULL);
+}
+
+bool SSD1306_RenderQueue::startTask(SSD1306& oled, uint32_t stackSize, UBaseType_t priority, BaseType_t core) {
+  if (task.load(std::memory_order_acquire)) return false;
+
+  stopped = xSemaphoreCreateBinary();
+  if (!stopped) return false;
+
+  target = &oled;
+  stopping.store(false, std::memory_order_release);
+
+  TaskHandle_t t;
+  if (xTaskCreatePinnedToCore(renderTask, "ssd1306", stackSize, this, priority, &t, core) != pdPASS) {
+    vSemaphoreDelete(stopped);
+    stopped = NULL;
+    return false;
+  }
+  task.store(t, std::memory_order_release);
+  return true;
+}
+
+void SSD1306_RenderQueue::stopTask() {
+  TaskHandle_t t = task.exchange(NULL);
+  if (!t) return;
+
+  // No post() may notify the task once it is gone
+  while (notifying.load()) taskYIELD();
+
+  // Wake the task and join it, it leaves after finishing the current process()
+  stopping.store(true, std::memory_order_release);
+  xTaskNotifyGive(t);
+  xSemaphoreTake(stopped, portMAX_DELAY);
+
+  vSemaphoreDelete(stopped);
+  stopped = NULL;
+}
+#endif
@@ -0,0 +1,131 @@
+#ifndef SSD1306_RENDERQUEUE_H
+#define SSD1306_RENDERQUEUE_H
+
+#include <atomic>
+#include "SSD1306.h"
+
+// Number of batches the queue can hold, must be a power of two
+#ifndef SSD1306_QUEUE_DEPTH
+#define SSD1306_QUEUE_DEPTH 8
+#endif
+
+// Maximum number of draw commands in one batch
+#ifndef SSD1306_BATCH_SIZE
+#define SSD1306_BATCH_SIZE 8
+#endif
+
+// Maximum text length (including null-byte) of a queued writeString
+#ifndef SSD1306_TEXT_LEN
+#define SSD1306_TEXT_LEN 22
+#endif
+
+enum DrawOp {
+  DRAW_CLEAR,
+  DRAW_PIXEL,
+  DRAW_HLINE,
+  DRAW_VLINE,
+  DRAW_LINE,
+  DRAW_RECT,
+  FILL_RECT,
+  DRAW_ROUNDRECT,
+  FILL_ROUNDRECT,
+  DRAW_CIRCLE,
+  FILL_CIRCLE,
+  DRAW_STRING
+};
+
+typedef struct {
+  uint8_t op;             /*!< DrawOp */
+  uint8_t color;          /*!< SSD1306_COLOR */
+  int16_t x0, y0;         /*!< Origin, cursor or first point */
+  int16_t x1, y1;         /*!< Size or second point */
+  int16_t r;              /*!< Radius */
+  const FontDef *font;    /*!< Font for DRAW_STRING */
+  char text[SSD1306_TEXT_LEN];
+} DrawCommand;
+
+// A group of draw commands that is applied to the framebuffer as a whole.
+// The render task never flushes in the middle of a batch, so everything a
+// producer puts into one batch lands on the panel in the same frame.
+class SSD1306_DrawBatch {
+public:
+  SSD1306_DrawBatch();
+  void reset();
+  uint8_t size() const { return count; }
+
+  // Each call returns false when the batch is full
+  bool clear(SSD1306_COLOR color = SSD1306_BLACK);
+  bool drawPixel(int16_t x, int16_t y, SSD1306_COLOR color);
+  bool drawHLine(int16_t x, int16_t y, int16_t w, SSD1306_COLOR color);
+  bool drawVLine(int16_t x, int16_t y, int16_t h, SSD1306_COLOR color);
+  bool drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR color);
+  bool drawRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool fillRect(int16_t x, int16_t y, int16_t w, int16_t h, SSD1306_COLOR color);
+  bool drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color);
+  bool fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, SSD1306_COLOR color);
+  bool drawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color);
+  bool fillCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR color);
+  // Text is copied into the batch and truncated to SSD1306_TEXT_LEN - 1 chars
+  bool writeString(int16_t x, int16_t y, const char* str, const FontDef& Font, SSD1306_COLOR color);
+
+  // Batches flush the display after being applied unless disabled here
+  void setFlush(bool flush) { this->Flush = flush; }
+
+  void apply(SSD1306& oled) const;
+
+private:
+  DrawCommand* next(uint8_t op, uint8_t color);
+
+  uint8_t count;
+  uint8_t Flush;
+  DrawCommand cmds[SSD1306_BATCH_SIZE];
+
+  friend class SSD1306_RenderQueue;
+};
+
+// Bounded lock-free multi-producer / single-consumer queue of draw batches.
+// Any task may post(); exactly one task (the render task) calls process(),
+// which is also the only place that touches the framebuffer and the bus.
+class SSD1306_RenderQueue {
+public:
+  SSD1306_RenderQueue();
+
+  // Producer side, safe to call from any task. Returns false if the queue is full.
+  bool post(const SSD1306_DrawBatch& batch);
+
+  // Consumer side. Applies every pending batch and flushes once at the end if
+  // any of them asked for it. Returns the number of batches applied.
+  uint16_t process(SSD1306& oled);
+
+  uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+#if defined(ESP32)
+  // Start a FreeRTOS task that sleeps until a batch is posted and then calls process()
+  bool startTask(SSD1306& oled, uint32_t stackSize = 4096, UBaseType_t priority = 1, BaseType_t core = tskNO_AFFINITY);
+  // Ask the render task to exit and wait until it has, a process() in progress
+  // is finished first. Must not be called from the render task itself.
+  void stopTask();
+#endif
+
+private:
+  typedef struct {
+    std::atomic<uint32_t> seq;
+    SSD1306_DrawBatch batch;
+  } Slot;
+
+  Slot slots[SSD1306_QUEUE_DEPTH];
+  std::atomic<uint32_t> head;
+  uint32_t tail;
+  std::atomic<uint32_t> droppedCount;
+
+#if defined(ESP32)
+  static void renderTask(void* arg);
+  std::atomic<TaskHandle_t> task;
+  std::atomic<uint32_t> notifying;  // post() calls that may still use `task`
+  std::atomic<bool> stopping;
+  SemaphoreHandle_t stopped;        // given by the render task on its way out
+  SSD1306* target;
+#endif
+};
+
+#endif  // SSD1306_RENDERQUEUE_H
@@ -0,0 +1,91 @@
+#include <Arduino.h>
+#include "SSD1306_Scheduler.h"
+
+SSD1306_FrameScheduler::SSD1306_FrameScheduler()
+  : Pending(0), CoalescedCount(0) {
+  this->Oled = NULL;
+  this->Period = 1000000 / 30;
+  this->NextSlot = 0;
+  this->LastHash = 0;
+  this->LastSeq = 0;
+  resetStats();
+}
+
+void SSD1306_FrameScheduler::begin(SSD1306& oled, uint8_t fps) {
+  this->Oled = &oled;
+  setTargetFps(fps);
+  this->NextSlot = micros();
+  // Nothing sent yet, the first frame always goes out
+  this->LastSeq = oled.frameSequence() - 1;
+}
+
+void SSD1306_FrameScheduler::setTargetFps(uint8_t fps) {
+  this->Period = 1000000 / (fps ? fps : 1);
+}
+
+void SSD1306_FrameScheduler::requestDisplay(bool dirtyOnly) {
+  uint8_t request = dirtyOnly ? REQUEST_DIRTY : REQUEST_FULL;
+
+  if (Pending.fetch_or(request, std::memory_order_acq_rel)) {
+    CoalescedCount.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool SSD1306_FrameScheduler::update() {
+  if (!Oled) return false;
+
+  uint32_t now = micros();
+  int32_t late = (int32_t)(now - NextSlot);
+  if (late < 0) return false;
+
+  // While idle the slot follows the clock, so a new request goes out at once
+  if (!pending()) {
+    NextSlot = now;
+    return false;
+  }
+
+  // Whole slots that passed since this one was due went without a frame
+  uint32_t missed = (uint32_t)late / Period;
+  DroppedCount += missed;
+  NextSlot += (missed + 1) * Period;
+
+  uint8_t request = Pending.exchange(0, std::memory_order_acq_rel);
+
+  // Skip frames we already sent, unless something else has flushed since
+  uint32_t hash = frameHash(Oled->getBuffer());
+  if (hash == LastHash && Oled->frameSequence() == LastSeq) {
+    SkippedCount++;
+    return false;
+  }
+
+  if (request & REQUEST_FULL) {
+    Oled->display();
+    LastHash = hash;
+    LastSeq = Oled->frameSequence();
+  } else {
+    Oled->displayDirty();
+    // Changes that were not marked dirty are still unsent, the panel does not
+    // show this frame and the next request must not be skipped
+    LastSeq = Oled->frameSequence() - 1;
+  }
+
+  FlushedCount++;
+  return true;
+}
+
+void SSD1306_FrameScheduler::resetStats() {
+  this->FlushedCount = 0;
+  this->CoalescedCount.store(0, std::memory_order_relaxed);
+  this->DroppedCount = 0;
+  this->SkippedCount = 0;
+}
+
+// FNV-1a over the framebuffer, a few microseconds against a millisecond for the flush
+uint32_t SSD1306_FrameScheduler::frameHash(const uint8_t* buffer) {
+  uint32_t h = 2166136261u;
+
+  for (uint16_t i = 0; i < SSD1306_BUFFER_SIZE; i++) {
+    h = (h ^ buffer[i]) * 16777619u;
+  }
+  return h;
+}
@@ -0,0 +1,56 @@
+#ifndef SSD1306_SCHEDULER_H
+#define SSD1306_SCHEDULER_H
+
+#include <atomic>
+#include "SSD1306.h"
+
+// Frame pacing: code that changed the framebuffer calls requestDisplay()
+// instead of display(), and the task that owns the bus calls update() from
+// its loop. All requests within one frame slot (1 / fps) end up in a single
+// flush, and a frame identical to the last one this scheduler sent in full
+// is not sent again.
+class SSD1306_FrameScheduler {
+public:
+  SSD1306_FrameScheduler();
+  void begin(SSD1306& oled, uint8_t fps = 30);
+  void setTargetFps(uint8_t fps);
+
+  // Safe to call from any task. With dirtyOnly only the spans marked with
+  // markDirty() are sent, unless another request in the same slot wants a full flush.
+  void requestDisplay(bool dirtyOnly = false);
+
+  // Flush if a request is pending and its frame slot has come, returns true
+  // when the panel was written
+  bool update();
+  bool pending() const { return Pending.load(std::memory_order_relaxed) != 0; }
+
+  uint32_t flushed() const { return FlushedCount; }
+  // Requests merged into a flush that was already pending
+  uint32_t coalesced() const { return CoalescedCount.load(std::memory_order_relaxed); }
+  // Frame slots that went by while a request waited for update()
+  uint32_t dropped() const { return DroppedCount; }
+  // Slots where the frame had not changed and nothing was sent
+  uint32_t skipped() const { return SkippedCount; }
+  void resetStats();
+
+private:
+  static uint32_t frameHash(const uint8_t* buffer);
+
+  enum {
+    REQUEST_DIRTY = 1,
+    REQUEST_FULL = 2
+  };
+
+  SSD1306* Oled;
+  std::atomic<uint8_t> Pending;
+  uint32_t Period;
+  uint32_t NextSlot;
+  uint32_t LastHash;
+  uint32_t LastSeq;
+  uint32_t FlushedCount;
+  std::atomic<uint32_t> CoalescedCount;
+  uint32_t DroppedCount;
+  uint32_t SkippedCount;
+};
+
+#endif  // SSD1306_SCHEDULER_H
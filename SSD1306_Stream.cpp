@@ -0,0 +1,225 @@
+#include <string.h>
+#include "SSD1306_Stream.h"
+
+// Unchanged bytes are still sent inside a run if the gap is shorter than a record header
+#define STREAM_MAX_GAP 3
+// Repeats shorter than this stay in the literal run
+#define STREAM_MIN_FILL 8
+
+enum {
+  S_SYNC0,
+  S_SYNC1,
+  S_FLAGS,
+  S_WIDTH,
+  S_PAGES,
+  S_HEADER,
+  S_COLUMN,
+  S_LENGTH,
+  S_DATA,
+  S_FILL,
+  S_CHECKSUM
+};
+
+// Emit [start, end) of one page as literal and fill records
+static uint8_t* emitRun(uint8_t* out, const uint8_t* src, uint8_t page, uint8_t start, uint8_t end) {
+  uint8_t lit = start;
+  uint8_t c = start;
+
+  while (c < end) {
+    uint8_t r = c + 1;
+    while (r < end && src[r] == src[c]) r++;
+
+    if (r - c >= STREAM_MIN_FILL) {
+      if (c > lit) {
+        *out++ = (STREAM_LITERAL << 4) | page;
+        *out++ = lit;
+        *out++ = c - lit;
+        memcpy(out, &src[lit], c - lit);
+        out += c - lit;
+      }
+      *out++ = (STREAM_FILL << 4) | page;
+      *out++ = c;
+      *out++ = r - c;
+      *out++ = src[c];
+      lit = r;
+    }
+    c = r;
+  }
+
+  if (end > lit) {
+    *out++ = (STREAM_LITERAL << 4) | page;
+    *out++ = lit;
+    *out++ = end - lit;
+    memcpy(out, &src[lit], end - lit);
+    out += end - lit;
+  }
+  return out;
+}
+
+size_t ssd1306_stream_encode(const uint8_t* prev, const uint8_t* cur, uint8_t w, uint8_t pages, uint8_t* out,
+                             uint8_t seq) {
+  uint8_t* p = out;
+
+  *p++ = STREAM_SYNC0;
+  *p++ = STREAM_SYNC1;
+  *p++ = (uint8_t)(seq << STREAM_SEQ_SHIFT) | (prev ? 0 : STREAM_KEYFRAME);
+  *p++ = w;
+  *p++ = pages;
+
+  for (uint8_t page = 0; page < pages; page++) {
+    const uint8_t* src = &cur[page * w];
+    const uint8_t* old = prev ? &prev[page * w] : NULL;
+    uint16_t c = 0;
+
+    while (c < w) {
+      if (old && old[c] == src[c]) {
+        c++;
+        continue;
+      }
+
+      // Extend the run over short stretches of unchanged bytes
+      uint16_t end = c + 1;
+      uint8_t gap = 0;
+      for (uint16_t j = c + 1; j < w; j++) {
+        if (!old || old[j] != src[j]) {
+          end = j + 1;
+          gap = 0;
+        } else if (++gap > STREAM_MAX_GAP) {
+          break;
+        }
+      }
+
+      p = emitRun(p, src, page, c, end);
+      c = end;
+    }
+  }
+
+  *p++ = STREAM_END;
+
+  uint8_t sum = 0;
+  for (uint8_t* q = out + 2; q < p; q++) sum += *q;
+  *p++ = sum;
+
+  return p - out;
+}
+
+SSD1306_StreamDecoder::SSD1306_StreamDecoder() {
+  begin(NULL, 0, 0);
+}
+
+void SSD1306_StreamDecoder::begin(uint8_t* buffer, uint8_t w, uint8_t pages, RunCallback onRun, void* ctx) {
+  this->Buffer = buffer;
+  this->W = w;
+  this->Pages = pages;
+  this->OnRun = onRun;
+  this->Ctx = ctx;
+  this->State = S_SYNC0;
+  this->Synced = 0;
+  this->Seq = 0;
+  this->Skip = 0;
+  this->Frames = 0;
+  this->Errors = 0;
+  this->Dropped = 0;
+}
+
+int8_t SSD1306_StreamDecoder::fail() {
+  this->Errors++;
+  this->State = S_SYNC0;
+  // Runs of the bad frame may be in the buffer already, only a keyframe repairs it
+  this->Synced = 0;
+  return ERROR;
+}
+
+int8_t SSD1306_StreamDecoder::feed(uint8_t b) {
+  if (State != S_SYNC0 && State != S_SYNC1 && State != S_CHECKSUM) Sum += b;
+
+  switch (State) {
+    case S_SYNC0:
+      if (b == STREAM_SYNC0) State = S_SYNC1;
+      break;
+
+    case S_SYNC1:
+      if (b == STREAM_SYNC1) {
+        Sum = 0;
+        State = S_FLAGS;
+      } else if (b != STREAM_SYNC0) {
+        State = S_SYNC0;
+      }
+      break;
+
+    case S_FLAGS:
+      if (b & STREAM_KEYFRAME) {
+        Skip = 0;
+      } else {
+        // A delta applies only on top of the frame before it
+        if (Synced && (b >> STREAM_SEQ_SHIFT) != Seq) Synced = 0;
+        Skip = !Synced;
+      }
+      Seq = ((b >> STREAM_SEQ_SHIFT) + 1) & 0x7F;
+      State = S_WIDTH;
+      break;
+
+    case S_WIDTH:
+      if (b != W) return fail();
+      State = S_PAGES;
+      break;
+
+    case S_PAGES:
+      if (b != Pages) return fail();
+      State = S_HEADER;
+      break;
+
+    case S_HEADER:
+      if (b == STREAM_END) {
+        State = S_CHECKSUM;
+        break;
+      }
+      Type = b >> 4;
+      Page = b & 0x0F;
+      if (Page >= Pages || Type > STREAM_FILL) return fail();
+      State = S_COLUMN;
+      break;
+
+    case S_COLUMN:
+      Column = b;
+      State = S_LENGTH;
+      break;
+
+    case S_LENGTH:
+      if (!b || Column + b > W) return fail();
+      Length = b;
+      // Decode in place, the framebuffer holds the previous frame
+      Dst = &Buffer[Page * W + Column];
+      Left = b;
+      State = (Type == STREAM_FILL) ? S_FILL : S_DATA;
+      break;
+
+    case S_DATA:
+      if (!Skip) *Dst++ = b;
+      if (--Left) break;
+      if (OnRun && !Skip) OnRun(Ctx, Page, Column, Length);
+      State = S_HEADER;
+      break;
+
+    case S_FILL:
+      if (!Skip) {
+        memset(Dst, b, Length);
+        if (OnRun) OnRun(Ctx, Page, Column, Length);
+      }
+      State = S_HEADER;
+      break;
+
+    case S_CHECKSUM:
+      State = S_SYNC0;
+      if (b != Sum) return fail();
+      if (Skip) {
+        Dropped++;
+        return DROPPED;
+      }
+      Synced = 1;
+      Frames++;
+      return FRAME;
+  }
+
+  return NONE;
+}
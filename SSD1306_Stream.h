@@ -0,0 +1,92 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef __SSD1306_STREAM_H__
+#define __SSD1306_STREAM_H__
+
+// Compact framebuffer stream for driving the display from a host.
+//
+// A frame is encoded against the previous one as runs of changed columns per
+// page, so the receiver decodes straight into its framebuffer (which holds the
+// previous frame) and only the touched spans need to be flushed:
+//
+//   0xA5 0x5A flags width pages { record } 0xFF checksum
+//   record:  (type << 4 | page) column length data
+//            type 0: `length` literal bytes, type 1: one byte repeated `length` times
+//
+// flags bit 0 marks a keyframe (all columns sent), bits 1-7 carry a sequence
+// number that counts up by one per frame. checksum is the 8-bit sum of all
+// bytes from flags up to and including the 0xFF end marker.
+//
+// A delta only applies to the frame it was encoded against. After a bad frame
+// (whose runs may already be in the framebuffer) or a gap in the sequence, the
+// decoder drops deltas until the next keyframe, so senders should send one
+// periodically.
+// This file has no Arduino dependencies and is shared with extras/tools.
+
+enum {
+  STREAM_SYNC0 = 0xA5,
+  STREAM_SYNC1 = 0x5A,
+  STREAM_END = 0xFF,
+  STREAM_KEYFRAME = 0x01,
+  STREAM_SEQ_SHIFT = 1,
+  STREAM_LITERAL = 0x00,
+  STREAM_FILL = 0x01
+};
+
+// Worst-case encoded size of one frame
+#define SSD1306_STREAM_MAX(w, pages) (7 + (size_t)(pages) * (3 + (w)))
+
+// Encode `cur` against `prev` (NULL for a keyframe) into `out`, returns the frame size.
+// `seq` is the frame number, only its low 7 bits are sent.
+size_t ssd1306_stream_encode(const uint8_t* prev, const uint8_t* cur, uint8_t w, uint8_t pages, uint8_t* out,
+                             uint8_t seq);
+
+// Incremental decoder, feed it bytes as they arrive
+class SSD1306_StreamDecoder {
+public:
+  enum {
+    NONE = 0,   // frame in progress
+    FRAME = 1,    // a frame was completed with a valid checksum
+    DROPPED = 2,  // a valid delta was ignored while waiting for a keyframe
+    ERROR = -1    // malformed frame or bad checksum, waiting for the next keyframe
+  };
+
+  // Called for every decoded run so the caller can mark it dirty
+  typedef void (*RunCallback)(void* ctx, uint8_t page, uint8_t column, uint8_t length);
+
+  SSD1306_StreamDecoder();
+  void begin(uint8_t* buffer, uint8_t w, uint8_t pages, RunCallback onRun = NULL, void* ctx = NULL);
+  int8_t feed(uint8_t b);
+
+  uint32_t frames() const { return Frames; }
+  uint32_t errors() const { return Errors; }
+  uint32_t dropped() const { return Dropped; }
+
+private:
+  int8_t fail();
+
+  uint8_t* Buffer;
+  uint8_t W;
+  uint8_t Pages;
+  RunCallback OnRun;
+  void* Ctx;
+
+  uint8_t State;
+  uint8_t Synced;  // the framebuffer holds the frame before Seq
+  uint8_t Seq;     // sequence number of the next delta
+  uint8_t Skip;    // current frame is parsed but not applied
+  uint8_t Sum;
+  uint8_t Type;
+  uint8_t Page;
+  uint8_t Column;
+  uint8_t Length;
+  uint8_t* Dst;  // next byte of the current run
+  uint8_t Left;  // bytes left in the current run
+
+  uint32_t Frames;
+  uint32_t Errors;
+  uint32_t Dropped;
+};
+
+#endif  // __SSD1306_STREAM_H__
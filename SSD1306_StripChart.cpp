@@ -0,0 +1,108 @@
+#include "SSD1306_StripChart.h"
+
+SSD1306_StripChart::SSD1306_StripChart(int16_t x, int16_t y, int16_t w, int16_t h, int16_t minValue, int16_t maxValue, uint8_t samplesPerColumn)
+  : SSD1306_Widget(x, y, (w < 1) ? 1 : (w > SSD1306_CHART_LEN) ? SSD1306_CHART_LEN : w, h) {
+  this->Min = minValue;
+  this->Max = (maxValue > minValue) ? maxValue : minValue + 1;
+  this->PerColumn = samplesPerColumn ? samplesPerColumn : 1;
+  reset();
+}
+
+void SSD1306_StripChart::reset() {
+  this->Head = 0;
+  this->Columns = 0;
+  this->Pending = 0;
+  this->AccN = 0;
+  this->HasLast = 0;
+  invalidate();
+}
+
+void SSD1306_StripChart::setRange(int16_t minValue, int16_t maxValue) {
+  this->Min = minValue;
+  this->Max = (maxValue > minValue) ? maxValue : minValue + 1;
+  invalidate();
+}
+
+void SSD1306_StripChart::setSamplesPerColumn(uint8_t n) {
+  this->PerColumn = n ? n : 1;
+  this->AccN = 0;
+}
+
+void SSD1306_StripChart::addSample(int16_t value) {
+  if (AccN == 0) {
+    AccLo = AccHi = value;
+  } else {
+    if (value < AccLo) AccLo = value;
+    if (value > AccHi) AccHi = value;
+  }
+
+  if (++AccN < PerColumn) return;
+
+  // Join to the previous column so the trace stays continuous
+  int16_t lo = AccLo, hi = AccHi;
+  if (HasLast) {
+    if (Last < lo) lo = Last;
+    if (Last > hi) hi = Last;
+  }
+
+  pushColumn(lo, hi);
+  this->Last = value;
+  this->HasLast = 1;
+  this->AccN = 0;
+}
+
+void SSD1306_StripChart::pushColumn(int16_t lo, int16_t hi) {
+  Lo[Head] = lo;
+  Hi[Head] = hi;
+  if (++Head >= W) Head = 0;
+
+  if (Columns < W) Columns++;
+  if (Pending < W) Pending++;
+  setDirty();
+}
+
+int16_t SSD1306_StripChart::toRow(int16_t value) const {
+  if (value < Min) value = Min;
+  if (value > Max) value = Max;
+
+  return Y + H - 1 - (int16_t)((int32_t)(value - Min) * (H - 1) / (Max - Min));
+}
+
+// Draw ring entry `index` as the plot column at screen x `cx`
+void SSD1306_StripChart::drawColumn(SSD1306& oled, int16_t cx, uint16_t index) {
+  int16_t top = toRow(Hi[index]);
+  int16_t bottom = toRow(Lo[index]);
+
+  oled.drawVLine(cx, Y, H, SSD1306_BLACK);
+  oled.drawVLine(cx, top, bottom - top + 1, SSD1306_WHITE);
+}
+
+// Shift the plot area left by n columns. Returns false if the plot is
+// clipped horizontally and has to be redrawn instead.
+bool SSD1306_StripChart::scroll(SSD1306& oled, int16_t n) {
+  int16_t x = X, y = Y, w = W, h = H;
+  if (!oled.clipToViewport(x, y, w, h)) return true;
+  if (w != W) return false;
+
+  oled.scrollRect(X, Y, W, H, -n, 0);
+  return true;
+}
+
+void SSD1306_StripChart::draw(SSD1306& oled, bool full) {
+  int16_t n = Pending;
+
+  if (full || n >= W || !scroll(oled, n)) {
+    oled.fillRect(X, Y, W, H, SSD1306_BLACK);
+    n = Columns;
+  }
+
+  // The newest n columns, oldest first, right-aligned
+  uint16_t index = (Head + W - n) % W;
+  for (int16_t cx = X + W - n; cx < X + W; cx++) {
+    drawColumn(oled, cx, index);
+    if (++index >= W) index = 0;
+  }
+
+  oled.markDirty(X, Y, W, H);
+  this->Pending = 0;
+}
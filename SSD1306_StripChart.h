@@ -0,0 +1,51 @@
+#ifndef SSD1306_STRIPCHART_H
+#define SSD1306_STRIPCHART_H
+
+#include "SSD1306_Widgets.h"
+
+// Maximum plot width in columns
+#ifndef SSD1306_CHART_LEN
+#define SSD1306_CHART_LEN SSD1306_WIDTH
+#endif
+
+// Scrolling plot of a sample stream. New columns enter on the right; instead of
+// redrawing the plot, the existing columns are shifted left with
+// SSD1306::scrollRect() and only the new columns are drawn. With
+// samplesPerColumn > 1 each column shows the min/max envelope of its samples,
+// so fast streams keep their peaks.
+class SSD1306_StripChart : public SSD1306_Widget {
+public:
+  SSD1306_StripChart(int16_t x, int16_t y, int16_t w, int16_t h, int16_t minValue, int16_t maxValue, uint8_t samplesPerColumn = 1);
+
+  void addSample(int16_t value);
+  void setRange(int16_t minValue, int16_t maxValue);
+  void setSamplesPerColumn(uint8_t n);
+  void reset();
+
+protected:
+  void draw(SSD1306& oled, bool full);
+
+private:
+  void pushColumn(int16_t lo, int16_t hi);
+  void drawColumn(SSD1306& oled, int16_t cx, uint16_t index);
+  bool scroll(SSD1306& oled, int16_t n);
+  int16_t toRow(int16_t value) const;
+
+  int16_t Min, Max;
+  uint8_t PerColumn;
+
+  // Ring buffer of column envelopes, Head is the next slot to write
+  int16_t Lo[SSD1306_CHART_LEN];
+  int16_t Hi[SSD1306_CHART_LEN];
+  uint16_t Head;
+  uint16_t Columns;  // valid columns in the ring
+  uint16_t Pending;  // columns added since the last render
+
+  // Samples of the column being collected
+  int16_t AccLo, AccHi;
+  uint8_t AccN;
+  int16_t Last;
+  uint8_t HasLast;
+};
+
+#endif  // SSD1306_STRIPCHART_H
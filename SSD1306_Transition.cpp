@@ -0,0 +1,137 @@
+#include <cstring>
+#include <Arduino.h>
+#include "SSD1306_Transition.h"
+
+SSD1306_Transition::SSD1306_Transition() {
+  this->Oled = NULL;
+  this->Running = 0;
+}
+
+void SSD1306_Transition::start(SSD1306& oled, const uint8_t* from, const uint8_t* to, uint8_t style, uint8_t direction,
+                               uint16_t duration_ms, uint8_t easing, uint8_t* output) {
+  this->Oled = &oled;
+  this->From = from;
+  this->To = to;
+  this->Style = style;
+  this->Direction = direction;
+  this->Easing = easing;
+  this->Duration = duration_ms ? duration_ms : 1;
+  this->Start = millis();
+  this->Running = 1;
+
+  oled.setBuffer(output);
+}
+
+bool SSD1306_Transition::update() {
+  if (!Running) return false;
+
+  uint32_t elapsed = millis() - Start;
+  if (elapsed >= Duration) {
+    compose(0xFFFF);
+    Oled->display();
+    this->Running = 0;
+    return false;
+  }
+
+  compose((uint16_t)(elapsed * 0xFFFF / Duration));
+  Oled->display();
+  return true;
+}
+
+// Map linear progress to eased progress, both 0..65535
+uint16_t SSD1306_Transition::ease(uint16_t t, uint8_t easing) {
+  uint32_t x = t;
+
+  switch (easing) {
+    case EASE_IN_OUT: {
+      // smoothstep: 3x^2 - 2x^3 = x^2 (3 - 2x), in one 64-bit product so no
+      // intermediate truncation can make it step back. Stays below 65536.
+      return (uint16_t)((uint64_t)(x * x) * (3 * 65536 - 2 * x) >> 32);
+    }
+    case EASE_OUT: {
+      // 1 - (1 - x)^2, exact at both ends
+      uint32_t inv = 0xFFFF - x;
+      return (uint16_t)(0xFFFF - (inv * inv) / 0xFFFF);
+    }
+    default:
+      return t;
+  }
+}
+
+void SSD1306_Transition::compose(uint16_t progress) {
+  bool vertical = Direction >= TRANSITION_UP;
+  int16_t size = vertical ? Oled->height() : Oled->width();
+  int16_t d = (progress == 0xFFFF) ? size : (int16_t)(((uint32_t)size * ease(progress, Easing)) >> 16);
+
+  // `to` covers [0, split) when moving right/down and [split, size) when
+  // moving left/up; k is how far each screen's content is displaced
+  bool toFirst = (Direction == TRANSITION_RIGHT || Direction == TRANSITION_DOWN);
+  int16_t split = toFirst ? d : size - d;
+  int16_t kTo = 0, kFrom = 0;
+
+  if (Style != TRANSITION_WIPE) kTo = toFirst ? d - size : size - d;
+  if (Style == TRANSITION_PUSH) kFrom = toFirst ? d : -d;
+
+  const uint8_t* first = toFirst ? To : From;
+  const uint8_t* second = toFirst ? From : To;
+  int16_t kFirst = toFirst ? kTo : kFrom;
+  int16_t kSecond = toFirst ? kFrom : kTo;
+
+  if (vertical) {
+    copyRows(first, 0, split, kFirst);
+    copyRows(second, split, size, kSecond);
+  } else {
+    copyColumns(first, 0, split, kFirst);
+    copyColumns(second, split, size, kSecond);
+  }
+}
+
+// Output columns [x0, x1) = source columns [x0 - k, x1 - k), one memcpy per page
+void SSD1306_Transition::copyColumns(const uint8_t* src, int16_t x0, int16_t x1, int16_t k) {
+  if (x0 >= x1) return;
+
+  uint8_t* out = Oled->getBuffer();
+  int16_t w = Oled->width();
+
+  for (int16_t p = 0; p < (Oled->height() >> 3); p++) {
+    memcpy(&out[p * w + x0], &src[p * w + x0 - k], x1 - x0);
+  }
+}
+
+// Output rows [y0, y1) = source rows [y0 - k, y1 - k). Each output byte is put
+// together from the two source pages it straddles.
+void SSD1306_Transition::copyRows(const uint8_t* src, int16_t y0, int16_t y1, int16_t k) {
+  if (y0 >= y1) return;
+
+  uint8_t* out = Oled->getBuffer();
+  int16_t w = Oled->width();
+  int16_t pages = Oled->height() >> 3;
+
+  for (int16_t p = y0 >> 3; p <= ((y1 - 1) >> 3); p++) {
+    int16_t top = p * 8;
+    uint8_t mask = 0xFF;
+    if (y0 > top) mask &= 0xFF << (y0 - top);
+    if (y1 < top + 8) mask &= 0xFF >> (top + 8 - y1);
+
+    // First source row of this output page, floor division for negative rows
+    int16_t r = top - k;
+    int16_t q = (r >= 0) ? (r >> 3) : -((7 - r) >> 3);
+    uint8_t s = r - q * 8;
+
+    const uint8_t* lo = (q >= 0 && q < pages) ? &src[q * w] : NULL;
+    const uint8_t* hi = (s && q + 1 >= 0 && q + 1 < pages) ? &src[(q + 1) * w] : NULL;
+    uint8_t* dst = &out[p * w];
+
+    if (mask == 0xFF && !s && lo) {
+      memcpy(dst, lo, w);
+      continue;
+    }
+
+    for (int16_t c = 0; c < w; c++) {
+      uint8_t val = 0;
+      if (lo) val = lo[c] >> s;
+      if (hi) val |= hi[c] << (8 - s);
+      dst[c] = (dst[c] & ~mask) | (val & mask);
+    }
+  }
+}
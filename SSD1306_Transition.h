@@ -0,0 +1,64 @@
+#ifndef SSD1306_TRANSITION_H
+#define SSD1306_TRANSITION_H
+
+#include "SSD1306.h"
+
+enum TransitionStyle {
+  TRANSITION_SLIDE = 0,  // new screen slides in over the old one
+  TRANSITION_PUSH = 1,   // new screen pushes the old one out
+  TRANSITION_WIPE = 2    // neither moves, the boundary between them does
+};
+
+enum TransitionDirection {
+  TRANSITION_LEFT = 0,
+  TRANSITION_RIGHT = 1,
+  TRANSITION_UP = 2,
+  TRANSITION_DOWN = 3
+};
+
+enum TransitionEasing {
+  EASE_LINEAR = 0,
+  EASE_IN_OUT = 1,
+  EASE_OUT = 2
+};
+
+// Animated change between two framebuffers (in the current rotation's layout,
+// SSD1306_BUFFER_SIZE bytes each). Every frame is composed straight from the
+// two screens: horizontal moves are per-page byte copies, vertical moves shift
+// bits across page boundaries, and the result is sent with display().
+class SSD1306_Transition {
+public:
+  SSD1306_Transition();
+
+  // `output` is bound as the oled's framebuffer for the transition, NULL uses the
+  // default one. It must not be `from` or `to`.
+  void start(SSD1306& oled, const uint8_t* from, const uint8_t* to, uint8_t style, uint8_t direction,
+             uint16_t duration_ms = 300, uint8_t easing = EASE_IN_OUT, uint8_t* output = NULL);
+
+  // Compose and flush the frame for the current time. Returns false once the
+  // final frame (equal to `to`) has been shown.
+  bool update();
+  bool running() const { return Running; }
+
+  // Compose the frame at progress 0..65535 into the output buffer without flushing
+  void compose(uint16_t progress);
+
+  // Map linear progress 0..65535 to eased progress (TransitionEasing), never decreasing
+  static uint16_t ease(uint16_t t, uint8_t easing);
+
+private:
+  void copyColumns(const uint8_t* src, int16_t x0, int16_t x1, int16_t k);
+  void copyRows(const uint8_t* src, int16_t y0, int16_t y1, int16_t k);
+
+  SSD1306* Oled;
+  const uint8_t* From;
+  const uint8_t* To;
+  uint8_t Style;
+  uint8_t Direction;
+  uint8_t Easing;
+  uint8_t Running;
+  uint16_t Duration;
+  uint32_t Start;
+};
+
+#endif  // SSD1306_TRANSITION_H
@@ -0,0 +1,215 @@
+#include <cstring>
+#include <math.h>
+#include "SSD1306_Widgets.h"
+#include "SSD1306_NumericField.h"
+
+SSD1306_Widget::SSD1306_Widget(int16_t x, int16_t y, int16_t w, int16_t h) {
+  this->X = x;
+  this->Y = y;
+  this->W = w;
+  this->H = h;
+  invalidate();
+}
+
+void SSD1306_Widget::invalidate() {
+  this->Dirty = 1;
+  this->Full = 1;
+}
+
+void SSD1306_Widget::render(SSD1306& oled) {
+  if (!Dirty) return;
+
+  draw(oled, Full);
+  this->Dirty = 0;
+  this->Full = 0;
+}
+
+SSD1306_ProgressBar::SSD1306_ProgressBar(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t maxValue)
+  : SSD1306_Widget(x, y, w, h) {
+  this->Max = maxValue ? maxValue : 1;
+  this->Value = 0;
+  this->Shown = 0;
+}
+
+void SSD1306_ProgressBar::setValue(uint16_t value) {
+  if (value > Max) value = Max;
+  if (value == Value) return;
+
+  this->Value = value;
+  if (fillWidth() != Shown) setDirty();
+}
+
+int16_t SSD1306_ProgressBar::fillWidth() const {
+  // Inner area leaves a one pixel gap inside the frame
+  return (int32_t)(W - 4) * Value / Max;
+}
+
+void SSD1306_ProgressBar::draw(SSD1306& oled, bool full) {
+  int16_t fill = fillWidth();
+
+  if (full) {
+    oled.fillRect(X, Y, W, H, SSD1306_BLACK);
+    oled.drawRect(X, Y, W, H);
+    oled.fillRect(X + 2, Y + 2, fill, H - 4, SSD1306_WHITE);
+    oled.markDirty(X, Y, W, H);
+  } else if (fill > Shown) {
+    oled.fillRect(X + 2 + Shown, Y + 2, fill - Shown, H - 4, SSD1306_WHITE);
+    oled.markDirty(X + 2 + Shown, Y + 2, fill - Shown, H - 4);
+  } else if (fill < Shown) {
+    oled.fillRect(X + 2 + fill, Y + 2, Shown - fill, H - 4, SSD1306_BLACK);
+    oled.markDirty(X + 2 + fill, Y + 2, Shown - fill, H - 4);
+  }
+
+  this->Shown = fill;
+}
+
+SSD1306_Label::SSD1306_Label(int16_t x, int16_t y, uint8_t chars, const FontDef& Font)
+  : SSD1306_Widget(x, y, 0, Font.FontHeight) {
+  this->Font = &Font;
+  this->Len = (chars > SSD1306_LABEL_LEN) ? SSD1306_LABEL_LEN : chars;
+  this->W = Len * Font.FontWidth;
+  memset(Text, ' ', Len);
+  Text[Len] = 0;
+}
+
+void SSD1306_Label::setText(const char* str) {
+  bool changed = false;
+
+  // Pad with spaces so shorter text erases the old tail
+  for (uint8_t i = 0; i < Len; i++) {
+    char c = *str ? *str++ : ' ';
+    if (Text[i] != c) {
+      Text[i] = c;
+      changed = true;
+    }
+  }
+
+  if (changed) setDirty();
+}
+
+void SSD1306_Label::setNumber(int32_t value, uint8_t decimals, uint8_t flags) {
+  char buf[SSD1306_LABEL_LEN + 1];
+
+  SSD1306_NumericField::format(value, Len, decimals, flags, buf);
+  setText(buf);
+}
+
+void SSD1306_Label::draw(SSD1306& oled, bool full) {
+  if (full) memset(Shown, 0, sizeof(Shown));
+
+  SSD1306_NumericField::drawCells(oled, X, Y, *Font, Text, Shown, Len, SSD1306_WHITE);
+}
+
+SSD1306_Icon::SSD1306_Icon(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t* const* frames, uint8_t count)
+  : SSD1306_Widget(x, y, w, h) {
+  this->Frames = frames;
+  this->Count = count;
+  this->Frame = 0;
+}
+
+void SSD1306_Icon::setFrame(uint8_t frame) {
+  if (frame >= Count) frame = Count - 1;
+  if (frame == Frame) return;
+
+  this->Frame = frame;
+  setDirty();
+}
+
+void SSD1306_Icon::draw(SSD1306& oled, bool full) {
+  (void)full;  // an icon is always redrawn as a whole
+
+  oled.fillRect(X, Y, W, H, SSD1306_BLACK);
+  oled.drawBitmap(Frames[Frame], X, Y, W, H, SSD1306_WHITE);
+  oled.markDirty(X, Y, W, H);
+}
+
+SSD1306_Gauge::SSD1306_Gauge(int16_t cx, int16_t cy, int16_t r, uint16_t maxValue)
+  : SSD1306_Widget(cx - r, cy - r, 2 * r + 1, r + 1) {
+  this->Cx = cx;
+  this->Cy = cy;
+  this->R = r;
+  this->Max = maxValue ? maxValue : 1;
+  this->Value = 0;
+  this->Shown = 0;
+}
+
+void SSD1306_Gauge::setValue(uint16_t value) {
+  if (value > Max) value = Max;
+  if (value == Value) return;
+
+  this->Value = value;
+  setDirty();
+}
+
+void SSD1306_Gauge::needleEnd(uint16_t value, int16_t* nx, int16_t* ny) const {
+  float a = (float)M_PI * (1.0f - (float)value / Max);
+  int16_t len = R - 2;
+
+  *nx = Cx + (int16_t)lroundf(len * cosf(a));
+  *ny = Cy - (int16_t)lroundf(len * sinf(a));
+}
+
+void SSD1306_Gauge::draw(SSD1306& oled, bool full) {
+  int16_t ox, oy, nx, ny;
+
+  needleEnd(Shown, &ox, &oy);
+  needleEnd(Value, &nx, &ny);
+
+  if (full) {
+    oled.fillRect(X, Y, W, H, SSD1306_BLACK);
+    oled.drawCircleHelper(Cx, Cy, R, 1 | 2, SSD1306_WHITE);
+    oled.drawPixel(Cx, Cy - R, SSD1306_WHITE);
+    oled.markDirty(X, Y, W, H);
+  } else {
+    oled.drawLine(Cx, Cy, ox, oy, SSD1306_BLACK);
+
+    // Union of the old and new needle, both start at the pivot
+    int16_t left = Cx, right = Cx, top = Cy;
+    if (ox < left) left = ox;
+    if (nx < left) left = nx;
+    if (ox > right) right = ox;
+    if (nx > right) right = nx;
+    if (oy < top) top = oy;
+    if (ny < top) top = ny;
+    oled.markDirty(left, top, right - left + 1, Cy - top + 1);
+  }
+
+  // Base line may have been crossed by the old needle
+  oled.drawHLine(X, Cy, W, SSD1306_WHITE);
+  oled.markDirty(X, Cy, W, 1);
+  oled.drawLine(Cx, Cy, nx, ny, SSD1306_WHITE);
+
+  this->Shown = Value;
+}
+
+SSD1306_Screen::SSD1306_Screen() {
+  this->Count = 0;
+}
+
+bool SSD1306_Screen::add(SSD1306_Widget& widget) {
+  if (Count >= SSD1306_SCREEN_WIDGETS) return false;
+
+  Widgets[Count++] = &widget;
+  return true;
+}
+
+void SSD1306_Screen::invalidate() {
+  for (uint8_t i = 0; i < Count; i++) Widgets[i]->invalidate();
+}
+
+uint8_t SSD1306_Screen::render(SSD1306& oled) {
+  uint8_t drawn = 0;
+
+  for (uint8_t i = 0; i < Count; i++) {
+    if (!Widgets[i]->isDirty()) continue;
+
+    Widgets[i]->render(oled);
+    drawn++;
+  }
+
+  return drawn;
+}
+
+void SSD1306_Screen::update(SSD1306& oled) {
+  if (render(oled)) oled.displayDirty();
+}
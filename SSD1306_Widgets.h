@@ -0,0 +1,137 @@
+#ifndef SSD1306_WIDGETS_H
+#define SSD1306_WIDGETS_H
+
+#include "SSD1306.h"
+
+// Maximum number of widgets on one screen
+#ifndef SSD1306_SCREEN_WIDGETS
+#define SSD1306_SCREEN_WIDGETS 16
+#endif
+
+// Maximum number of characters in a label
+#ifndef SSD1306_LABEL_LEN
+#define SSD1306_LABEL_LEN 18
+#endif
+
+// Base class of all widgets. A widget owns its bounding box, remembers what it
+// drew last and on render() only draws the difference to its current state,
+// marking the touched area with markDirty() so displayDirty() sends just that.
+class SSD1306_Widget {
+public:
+  SSD1306_Widget(int16_t x, int16_t y, int16_t w, int16_t h);
+  virtual ~SSD1306_Widget() {}
+
+  bool isDirty() const { return Dirty; }
+  // Force a full redraw on the next render()
+  void invalidate();
+  void render(SSD1306& oled);
+
+  int16_t x() const { return X; }
+  int16_t y() const { return Y; }
+  int16_t w() const { return W; }
+  int16_t h() const { return H; }
+
+protected:
+  // full: the widget area is undefined and must be drawn completely
+  virtual void draw(SSD1306& oled, bool full) = 0;
+  void setDirty() { Dirty = 1; }
+
+  int16_t X, Y, W, H;
+
+private:
+  uint8_t Dirty;
+  uint8_t Full;
+};
+
+// Horizontal bar with a 1 pixel frame, only the changed span is filled or cleared
+class SSD1306_ProgressBar : public SSD1306_Widget {
+public:
+  SSD1306_ProgressBar(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t maxValue = 100);
+  void setValue(uint16_t value);
+  uint16_t getValue() const { return Value; }
+
+protected:
+  void draw(SSD1306& oled, bool full);
+
+private:
+  int16_t fillWidth() const;
+
+  uint16_t Max;
+  uint16_t Value;
+  int16_t Shown;  // filled width currently on screen
+};
+
+// Fixed-width text, only the character cells that changed are redrawn. Cells
+// follow the oled's text scale at render(), the widget extent is the scale 1 one.
+class SSD1306_Label : public SSD1306_Widget {
+public:
+  SSD1306_Label(int16_t x, int16_t y, uint8_t chars, const FontDef& Font);
+  void setText(const char* str);
+  // Set the text to a formatted number, see SSD1306_NumericField::format()
+  void setNumber(int32_t value, uint8_t decimals = 0, uint8_t flags = 0);
+
+protected:
+  void draw(SSD1306& oled, bool full);
+
+private:
+  const FontDef* Font;
+  uint8_t Len;
+  char Text[SSD1306_LABEL_LEN + 1];
+  char Shown[SSD1306_LABEL_LEN + 1];
+};
+
+// Page-format bitmap (see SSD1306_Bitmap.h) chosen from a set of frames,
+// e.g. battery or signal levels. Redrawn only when the frame changes.
+class SSD1306_Icon : public SSD1306_Widget {
+public:
+  SSD1306_Icon(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t* const* frames, uint8_t count);
+  void setFrame(uint8_t frame);
+  uint8_t getFrame() const { return Frame; }
+
+protected:
+  void draw(SSD1306& oled, bool full);
+
+private:
+  const uint8_t* const* Frames;
+  uint8_t Count;
+  uint8_t Frame;
+};
+
+// Half-circle gauge with a needle, moving the needle erases only the old needle
+class SSD1306_Gauge : public SSD1306_Widget {
+public:
+  // (cx, cy) is the needle pivot, the scale runs from the left (0) to the right (maxValue)
+  SSD1306_Gauge(int16_t cx, int16_t cy, int16_t r, uint16_t maxValue = 100);
+  void setValue(uint16_t value);
+  uint16_t getValue() const { return Value; }
+
+protected:
+  void draw(SSD1306& oled, bool full);
+
+private:
+  void needleEnd(uint16_t value, int16_t* nx, int16_t* ny) const;
+
+  int16_t Cx, Cy, R;
+  uint16_t Max;
+  uint16_t Value;
+  uint16_t Shown;
+};
+
+// Collection of widgets rendered together before a single flush
+class SSD1306_Screen {
+public:
+  SSD1306_Screen();
+  bool add(SSD1306_Widget& widget);
+  void invalidate();
+
+  // Render every dirty widget, returns how many were drawn
+  uint8_t render(SSD1306& oled);
+  // render() followed by displayDirty() if anything changed
+  void update(SSD1306& oled);
+
+private:
+  SSD1306_Widget* Widgets[SSD1306_SCREEN_WIDGETS];
+  uint8_t Count;
+};
+
+#endif  // SSD1306_WIDGETS_H
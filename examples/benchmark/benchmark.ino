@@ -0,0 +1,71 @@
+// Measures bus throughput of writeCommand(), display() and displayDirty(),
+// once with DC/CS toggled through the GPIO registers and once through
+// digitalWrite() (setFastGpio(false)), and prints both with the speedup.
+#include "SSD1306.h"
+
+#define OLED_MOSI 13
+#define OLED_CLK 14
+#define OLED_DC 26
+#define OLED_CS 33
+#define OLED_RESET 25
+
+SSD1306 oled(OLED_MOSI, OLED_CLK, OLED_DC, OLED_RESET, OLED_CS);
+
+typedef struct {
+  uint32_t cmd;    // us for `commands` writeCommand() calls
+  uint32_t frame;  // us for `frames` display() calls
+  uint32_t dirty;  // us for `frames` 16x16 displayDirty() calls
+} Timing;
+
+static const uint32_t commands = 10000;
+static const uint32_t frames = 100;
+
+static Timing measure(bool fast) {
+  Timing t;
+  oled.setFastGpio(fast);
+
+  uint32_t t0 = micros();
+  for (uint32_t i = 0; i < commands; i++) oled.writeCommand(SSD1306_NOP);
+  t.cmd = micros() - t0;
+
+  t0 = micros();
+  for (uint32_t i = 0; i < frames; i++) oled.display();
+  t.frame = micros() - t0;
+
+  oled.drawRect(0, 0, 16, 16);
+  t0 = micros();
+  for (uint32_t i = 0; i < frames; i++) {
+    oled.markDirty(0, 0, 16, 16);
+    oled.displayDirty();
+  }
+  t.dirty = micros() - t0;
+
+  return t;
+}
+
+static void report(const char* name, const Timing& t) {
+  Serial.printf("%-12s %8.2f %10lu %10lu\n", name, (float)t.cmd / commands, (unsigned long)(t.frame / frames),
+                (unsigned long)(t.dirty / frames));
+}
+
+void setup() {
+  Serial.begin(115200);
+  oled.init();
+
+#if !defined(SSD1306_FAST_GPIO)
+  Serial.println("GPIO register path not available, both runs use digitalWrite");
+#endif
+}
+
+void loop() {
+  Timing slow = measure(false);
+  Timing fast = measure(true);
+
+  Serial.printf("%-12s %8s %10s %10s\n", "DC/CS", "us/cmd", "us/frame", "us/dirty");
+  report("digitalWrite", slow);
+  report("registers", fast);
+  Serial.printf("%-12s %7.2fx %9.2fx %9.2fx\n\n", "speedup", (float)slow.cmd / fast.cmd, (float)slow.frame / fast.frame,
+                (float)slow.dirty / fast.dirty);
+
+  delay(2000);
+}
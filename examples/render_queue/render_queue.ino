@@ -0,0 +1,39 @@
+#include "SSD1306.h"
+#include "SSD1306_RenderQueue.h"
+
+#define OLED_MOSI 13
+#define OLED_CLK 14
+#define OLED_DC 26
+#define OLED_CS 33
+#define OLED_RESET 25
+
+SSD1306 oled(OLED_MOSI, OLED_CLK, OLED_DC, OLED_RESET, OLED_CS);
+SSD1306_RenderQueue renderQueue;
+
+// Each producer task owns one half of the screen
+void counterTask(void* arg) {
+  int16_t x = (int16_t)(intptr_t)arg;
+  uint32_t n = 0;
+  char buf[12];
+
+  for (;;) {
+    SSD1306_DrawBatch batch;
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)n++);
+    batch.fillRect(x, 20, 64, 10, SSD1306_BLACK);
+    batch.writeString(x + 2, 20, buf, Font_7x10, SSD1306_WHITE);
+    renderQueue.post(batch);
+    vTaskDelay(pdMS_TO_TICKS(x ? 50 : 120));
+  }
+}
+
+void setup() {
+  oled.init();
+  renderQueue.startTask(oled);
+
+  xTaskCreate(counterTask, "left", 2048, (void*)0, 1, NULL);
+  xTaskCreate(counterTask, "right", 2048, (void*)64, 1, NULL);
+}
+
+void loop() {
+  vTaskDelay(portMAX_DELAY);
+}
@@ -0,0 +1,26 @@
+// Host stand-in for the Arduino core, just enough to build the driver on Linux
+// against SSD1306_Emulator. Pin writes go to the attached emulator, and time
+// is virtual: delay() and every byte on the emulated bus advance micros().
+
+#ifndef SSD1306_HOST_ARDUINO_H
+#define SSD1306_HOST_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long micros();
+unsigned long millis();
+inline void yield() {}
+
+#endif  // SSD1306_HOST_ARDUINO_H
@@ -0,0 +1,38 @@
+// Host stand-in for the Arduino SPI library, every byte sent goes to the
+// attached SSD1306_Emulator
+
+#ifndef SSD1306_HOST_SPI_H
+#define SSD1306_HOST_SPI_H
+
+#include "Arduino.h"
+
+#define HSPI 2
+#define VSPI 3
+#define SPI_MSBFIRST 1
+#define SPI_MODE0 0
+#define SPI_CLOCK_DIV2 2
+
+void ssd1306_host_transfer(uint8_t data);
+
+class SPIClass {
+public:
+  SPIClass(uint8_t bus = HSPI) { (void)bus; }
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+  }
+  void setBitOrder(uint8_t order) { (void)order; }
+  void setDataMode(uint8_t mode) { (void)mode; }
+  void setClockDivider(uint32_t div) { (void)div; }
+  uint8_t transfer(uint8_t data) {
+    ssd1306_host_transfer(data);
+    return 0;
+  }
+  void writeBytes(const uint8_t* data, uint32_t size) {
+    while (size--) ssd1306_host_transfer(*data++);
+  }
+};
+
+#endif  // SSD1306_HOST_SPI_H
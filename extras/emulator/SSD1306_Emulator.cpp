@@ -0,0 +1,405 @@
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include "Arduino.h"
+#include "SPI.h"
+#include "SSD1306_Emulator.h"
+
+SSD1306_Emulator* SSD1306_Emulator::Attached = NULL;
+
+// Virtual time in nanoseconds, see Arduino.h
+static uint64_t ClockNs = 0;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (SSD1306_Emulator::attached()) SSD1306_Emulator::attached()->pinWrite(pin, val);
+}
+
+void delay(unsigned long ms) {
+  ClockNs += (uint64_t)ms * 1000000;
+}
+
+void delayMicroseconds(unsigned int us) {
+  ClockNs += (uint64_t)us * 1000;
+}
+
+unsigned long micros() {
+  return (unsigned long)(ClockNs / 1000);
+}
+
+unsigned long millis() {
+  return (unsigned long)(ClockNs / 1000000);
+}
+
+void ssd1306_host_transfer(uint8_t data) {
+  SSD1306_Emulator* emu = SSD1306_Emulator::attached();
+  uint32_t hz = emu ? emu->busClock() : 8000000;
+
+  ClockNs += 8000000000ULL / hz;
+  if (emu) emu->receive(data);
+}
+
+SSD1306_Emulator::SSD1306_Emulator(int8_t dcPin, int8_t csPin, int8_t rstPin, Controller type) {
+  this->Type = type;
+  this->DcPin = dcPin;
+  this->CsPin = csPin;
+  this->RstPin = rstPin;
+  this->Dc = 0;
+  this->Cs = 0;
+  this->InReset = 0;
+  this->Carried = 0;
+  this->BusClock = 8000000;
+
+  // The real RAM powers up with random content, start from a known one
+  memset(Ram, 0, sizeof(Ram));
+  reset();
+  resetStats();
+}
+
+SSD1306_Emulator::~SSD1306_Emulator() {
+  detach();
+}
+
+void SSD1306_Emulator::attach() {
+  Attached = this;
+}
+
+void SSD1306_Emulator::detach() {
+  if (Attached == this) Attached = NULL;
+}
+
+// Register defaults after RST, the display RAM keeps its content
+void SSD1306_Emulator::reset() {
+  ArgsWanted = 0;
+  ArgsHave = 0;
+
+  Mode = 2;
+  Page = 0;
+  Column = 0;
+  ColumnBase = 0;
+  ColumnStart = 0;
+  ColumnEnd = PANEL_WIDTH - 1;
+  PageStart = 0;
+  PageEnd = RAM_PAGES - 1;
+  RmwColumn = 0;
+  Rmw = 0;
+
+  DisplayOn = 0;
+  EntireOn = 0;
+  Invert = 0;
+  Contrast = (Type == CONTROLLER_SH1106) ? 0x80 : 0x7F;
+  StartLine = 0;
+  Offset = 0;
+  Multiplex = 63;
+  SegRemap = 0;
+  ComReverse = 0;
+
+  ScrollActive = 0;
+  ScrollLeft = 0;
+  ScrollPageStart = 0;
+  ScrollPageEnd = 0;
+  ScrollVertical = 0;
+  VScroll = 0;
+  AreaTop = 0;
+  AreaRows = 64;
+}
+
+void SSD1306_Emulator::resetStats() {
+  memset(&Stats, 0, sizeof(Stats));
+}
+
+void SSD1306_Emulator::pinWrite(uint8_t pin, uint8_t level) {
+  if ((int8_t)pin == RstPin) {
+    if (level == LOW) reset();
+    InReset = (level == LOW);
+  }
+  if ((int8_t)pin == DcPin) Dc = level;
+  if ((int8_t)pin == CsPin) {
+    Cs = (level == LOW);
+    Carried = 0;
+  }
+}
+
+void SSD1306_Emulator::receive(uint8_t data) {
+  if (InReset) return;
+  if (CsPin >= 0 && !Cs) return;
+
+  if (CsPin >= 0 && !Carried) {
+    Carried = 1;
+    Stats.transactions++;
+  }
+
+  if (Dc) {
+    Stats.dataBytes++;
+    writeRam(data);
+  } else {
+    Stats.commandBytes++;
+    command(data);
+  }
+}
+
+// Collect a command and its arguments, execute when complete
+void SSD1306_Emulator::command(uint8_t cmd) {
+  if (ArgsHave < ArgsWanted) {
+    Args[ArgsHave++] = cmd;
+    if (ArgsHave == ArgsWanted) execute();
+    return;
+  }
+
+  Cmd = cmd;
+  ArgsWanted = argCount(cmd);
+  ArgsHave = 0;
+  if (!ArgsWanted) execute();
+}
+
+uint8_t SSD1306_Emulator::argCount(uint8_t cmd) const {
+  switch (cmd) {
+    case 0x81: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+  }
+
+  if (Type == CONTROLLER_SH1106) return (cmd == 0xAD) ? 1 : 0;
+
+  switch (cmd) {
+    case 0x20: case 0x8D: return 1;
+    case 0x21: case 0x22: case 0xA3: return 2;
+    case 0x29: case 0x2A: return 5;
+    case 0x26: case 0x27: return 6;
+  }
+  return 0;
+}
+
+void SSD1306_Emulator::execute() {
+  uint8_t c = Cmd;
+  bool sh1106 = (Type == CONTROLLER_SH1106);
+  bool pageMode = sh1106 || Mode == 2;
+
+  ArgsWanted = 0;
+  ArgsHave = 0;
+  Stats.commands++;
+
+  if (c <= 0x0F) {
+    if (pageMode) Column = ColumnBase = (ColumnBase & 0xF0) | (c & 0x0F);
+  } else if (c <= 0x1F) {
+    uint8_t high = sh1106 ? (c & 0x0F) : (c & 0x07);
+    if (pageMode) Column = ColumnBase = (ColumnBase & 0x0F) | (high << 4);
+  } else if (c >= 0x40 && c <= 0x7F) {
+    StartLine = c & 0x3F;
+  } else if (c >= 0xB0 && c <= 0xB7) {
+    if (pageMode) Page = c & 0x07;
+  } else if (c == 0xC0 || c == 0xC8 || (sh1106 && c >= 0xC0 && c <= 0xCF)) {
+    ComReverse = (c >> 3) & 1;
+  } else if (!(sh1106 ? executeSH1106(c) : executeSSD1306(c))) {
+    Stats.commands--;
+    Stats.unknown++;
+  }
+}
+
+// Commands both controllers implement, false if `c` is not one of them
+bool SSD1306_Emulator::executeCommon(uint8_t c) {
+  switch (c) {
+    case 0x81: Contrast = Args[0]; break;
+    case 0xA0: case 0xA1: SegRemap = c & 1; break;
+    case 0xA4: case 0xA5: EntireOn = c & 1; break;
+    case 0xA6: case 0xA7: Invert = c & 1; break;
+    case 0xA8: if ((Args[0] & 0x3F) >= 15) Multiplex = Args[0] & 0x3F; break;
+    case 0xAE: case 0xAF: DisplayOn = c & 1; break;
+    case 0xD3: Offset = Args[0] & 0x3F; break;
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB: case 0xE3: break;  // timing, wiring, nop
+    default: return false;
+  }
+  return true;
+}
+
+bool SSD1306_Emulator::executeSSD1306(uint8_t c) {
+  switch (c) {
+    case 0x20:
+      if ((Args[0] & 3) != 3) Mode = Args[0] & 3;
+      break;
+    case 0x21:
+      if (Mode == 2) break;
+      ColumnStart = Args[0] & 0x7F;
+      ColumnEnd = Args[1] & 0x7F;
+      Column = ColumnStart;
+      break;
+    case 0x22:
+      if (Mode == 2) break;
+      PageStart = Args[0] & 0x07;
+      PageEnd = Args[1] & 0x07;
+      Page = PageStart;
+      break;
+    case 0x26: case 0x27: case 0x29: case 0x2A:
+      ScrollLeft = (c == 0x27 || c == 0x2A);
+      ScrollPageStart = Args[1] & 0x07;
+      ScrollPageEnd = Args[3] & 0x07;
+      ScrollVertical = (c >= 0x29) ? (Args[4] & 0x3F) : 0;
+      break;
+    case 0x2E: ScrollActive = 0; break;
+    case 0x2F: ScrollActive = 1; VScroll = 0; break;
+    case 0xA3:
+      AreaTop = Args[0] & 0x3F;
+      AreaRows = Args[1] & 0x7F;
+      break;
+    case 0x8D: break;  // charge pump
+    default: return executeCommon(c);
+  }
+  return true;
+}
+
+bool SSD1306_Emulator::executeSH1106(uint8_t c) {
+  switch (c) {
+    case 0x30: case 0x31: case 0x32: case 0x33: break;  // pump voltage
+    case 0xAD: break;                                   // DC-DC control
+    case 0xE0:                                          // read-modify-write
+      Rmw = 1;
+      RmwColumn = Column;
+      break;
+    case 0xEE:
+      if (Rmw) Column = RmwColumn;
+      Rmw = 0;
+      break;
+    default: return executeCommon(c);
+  }
+  return true;
+}
+
+void SSD1306_Emulator::writeRam(uint8_t data) {
+  uint8_t width = (Type == CONTROLLER_SH1106) ? RAM_COLUMNS : PANEL_WIDTH;
+
+  if (Page < RAM_PAGES && Column < width) Ram[Page][Column] = data;
+
+  if (Type == CONTROLLER_SH1106 || Mode == 2) {
+    // Page addressing: the column wraps, the page stays
+    if (++Column >= width) Column = ColumnBase;
+  } else if (Mode == 0) {
+    if (Column++ < ColumnEnd) return;
+    Column = ColumnStart;
+    if (Page++ >= PageEnd) Page = PageStart;
+  } else {
+    if (Page++ < PageEnd) return;
+    Page = PageStart;
+    if (Column++ >= ColumnEnd) Column = ColumnStart;
+  }
+}
+
+void SSD1306_Emulator::scrollStep() {
+  if (!ScrollActive || Type == CONTROLLER_SH1106) return;
+
+  for (uint8_t p = ScrollPageStart;; p = (p + 1) & 7) {
+    uint8_t* row = Ram[p];
+    if (ScrollLeft) {
+      uint8_t first = row[0];
+      memmove(row, row + 1, PANEL_WIDTH - 1);
+      row[PANEL_WIDTH - 1] = first;
+    } else {
+      uint8_t last = row[PANEL_WIDTH - 1];
+      memmove(row + 1, row, PANEL_WIDTH - 1);
+      row[0] = last;
+    }
+    if (p == ScrollPageEnd) break;
+  }
+
+  if (ScrollVertical && AreaRows) VScroll = (VScroll + ScrollVertical) % AreaRows;
+}
+
+uint8_t SSD1306_Emulator::pixel(uint8_t x, uint8_t y) const {
+  if (!DisplayOn || x >= PANEL_WIDTH || y > Multiplex) return 0;
+  if (EntireOn) return 1;
+
+  // Panel row -> COM -> display row -> RAM line
+  uint8_t com = ComReverse ? Multiplex - y : y;
+  uint8_t row = (com + Offset) & 63;
+  if (ScrollActive && AreaRows && row >= AreaTop && row < AreaTop + AreaRows)
+    row = AreaTop + (row - AreaTop + VScroll) % AreaRows;
+  uint8_t line = (row + StartLine) & 63;
+
+  // Panel column -> segment -> RAM column
+  bool sh1106 = (Type == CONTROLLER_SH1106);
+  uint8_t width = sh1106 ? RAM_COLUMNS : PANEL_WIDTH;
+  uint8_t seg = x + (sh1106 ? 2 : 0);
+  uint8_t col = SegRemap ? width - 1 - seg : seg;
+
+  return ((Ram[line >> 3][col] >> (line & 7)) & 1) ^ Invert;
+}
+
+bool SSD1306_Emulator::writePBM(const char* path) const {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+
+  fprintf(f, "P4\n%d %d\n", PANEL_WIDTH, rows());
+  for (uint8_t y = 0; y < rows(); y++) {
+    uint8_t line[PANEL_WIDTH / 8] = { 0 };
+    for (uint8_t x = 0; x < PANEL_WIDTH; x++) {
+      if (pixel(x, y)) line[x >> 3] |= 0x80 >> (x & 7);
+    }
+    fwrite(line, 1, sizeof(line), f);
+  }
+  return fclose(f) == 0;
+}
+
+static int readToken(FILE* f) {
+  int c;
+
+  // Skip whitespace and comments
+  for (;;) {
+    c = fgetc(f);
+    if (c == '#') {
+      while (c != '\n' && c != EOF) c = fgetc(f);
+    } else if (!isspace(c)) {
+      break;
+    }
+  }
+  if (c == EOF || !isdigit(c)) return -1;
+
+  int v = 0;
+  while (c != EOF && isdigit(c)) {
+    v = v * 10 + (c - '0');
+    c = fgetc(f);
+  }
+  return v;
+}
+
+long SSD1306_Emulator::diffPBM(const char* path) const {
+  FILE* f = fopen(path, "rb");
+  if (!f) return -1;
+
+  char magic[2];
+  if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || (magic[1] != '1' && magic[1] != '4')) {
+    fclose(f);
+    return -1;
+  }
+  int w = readToken(f);
+  int h = readToken(f);
+  if (w != PANEL_WIDTH || h != rows()) {
+    fclose(f);
+    return -1;
+  }
+
+  long diff = 0;
+  for (int y = 0; y < h; y++) {
+    uint8_t line[PANEL_WIDTH / 8] = { 0 };
+
+    if (magic[1] == '4') {
+      if (fread(line, 1, sizeof(line), f) != sizeof(line)) diff = -1;
+    } else {
+      for (int x = 0; x < w && diff >= 0; x++) {
+        int c;
+        do c = fgetc(f);
+        while (c != EOF && c != '0' && c != '1');
+        if (c == EOF) diff = -1;
+        if (c == '1') line[x >> 3] |= 0x80 >> (x & 7);
+      }
+    }
+    if (diff < 0) break;
+
+    for (int x = 0; x < w; x++) {
+      if (((line[x >> 3] >> (7 - (x & 7))) & 1) != pixel(x, y)) diff++;
+    }
+  }
+  fclose(f);
+  return diff;
+}
@@ -0,0 +1,151 @@
+// Host-side model of the SSD1306 / SH1106 controller for testing without a
+// panel. It decodes the command and data bytes the driver clocks out, keeps
+// the controller's display RAM and addressing state, and shows what the
+// panel would show: column offset, start line, display offset, segment remap,
+// COM scan direction, inversion and (SSD1306) scrolling are applied.
+//
+// The host shims in this directory (Arduino.h, SPI.h) route digitalWrite()
+// and SPIClass::transfer() to the attached emulator, so the unchanged driver
+// runs on Linux:
+//
+//   SSD1306_Emulator panel(DC, CS, RST);
+//   SSD1306 oled(MOSI, CLK, DC, RST, CS);
+//   panel.attach();
+//   oled.init();
+//   ...draw...
+//   panel.resetStats();
+//   oled.display();
+//   // panel.stats().dataBytes == 1024, panel.diffPBM("golden.pbm") == 0
+//
+// Addressing follows the datasheets: the SSD1306 honours 00-1F/B0-B7 only in
+// page addressing mode and 21h/22h only in horizontal/vertical mode. The
+// SH1106 has page addressing only, 132 RAM columns of which the 128 panel
+// columns start at column 2, and ignores the SSD1306-only commands.
+
+#ifndef SSD1306_EMULATOR_H
+#define SSD1306_EMULATOR_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint32_t commands;      // decoded commands, arguments included
+  uint32_t commandBytes;  // bytes sent with DC low
+  uint32_t dataBytes;     // bytes sent with DC high
+  uint32_t transactions;  // CS assertions that carried at least one byte
+  uint32_t unknown;       // command bytes the controller does not implement
+} SSD1306_EmulatorStats;
+
+class SSD1306_Emulator {
+public:
+  enum Controller {
+    CONTROLLER_SSD1306,
+    CONTROLLER_SH1106
+  };
+
+  static const uint8_t PANEL_WIDTH = 128;
+  static const uint8_t RAM_PAGES = 8;
+  static const uint8_t RAM_COLUMNS = 132;
+
+  // Pins as passed to the driver, a negative pin is treated as always asserted
+  SSD1306_Emulator(int8_t dcPin, int8_t csPin, int8_t rstPin, Controller type = CONTROLLER_SH1106);
+  ~SSD1306_Emulator();
+
+  // Receive the pin writes and SPI bytes of the host shims, one emulator at a time
+  void attach();
+  void detach();
+
+  // Power-on state, also entered when the driver pulls RST low
+  void reset();
+  void pinWrite(uint8_t pin, uint8_t level);
+  void receive(uint8_t data);
+
+  // Advance an active horizontal scroll by one step, the controller does this
+  // every `interval` frames. Like the real thing, the RAM content moves.
+  void scrollStep();
+
+  // Panel pixel as seen by the user, x < 128, y < rows()
+  uint8_t pixel(uint8_t x, uint8_t y) const;
+  uint8_t rows() const { return Multiplex + 1; }
+  // Display RAM, RAM_COLUMNS bytes per page whatever the controller
+  const uint8_t* ram() const { return &Ram[0][0]; }
+
+  bool displayOn() const { return DisplayOn; }
+  uint8_t contrast() const { return Contrast; }
+
+  const SSD1306_EmulatorStats& stats() const { return Stats; }
+  void resetStats();
+
+  // Bus speed used to advance micros() per byte, 8 MHz by default
+  void setBusClock(uint32_t hz) { this->BusClock = hz; }
+  uint32_t busClock() const { return BusClock; }
+
+  // Panel image as binary PBM (P4), lit pixels are 1. diffPBM() returns the
+  // number of pixels that differ from a P1/P4 image, -1 if it can't be read
+  // or has a different size.
+  bool writePBM(const char* path) const;
+  long diffPBM(const char* path) const;
+
+  static SSD1306_Emulator* attached() { return Attached; }
+
+private:
+  void command(uint8_t cmd);
+  void execute();
+  bool executeCommon(uint8_t c);
+  bool executeSSD1306(uint8_t c);
+  bool executeSH1106(uint8_t c);
+  void writeRam(uint8_t data);
+  uint8_t argCount(uint8_t cmd) const;
+
+  static SSD1306_Emulator* Attached;
+
+  Controller Type;
+  int8_t DcPin;
+  int8_t CsPin;
+  int8_t RstPin;
+  uint8_t Dc;
+  uint8_t Cs;
+  uint8_t InReset;
+  uint8_t Carried;  // current CS assertion has carried a byte
+  uint32_t BusClock;
+
+  uint8_t Ram[RAM_PAGES][RAM_COLUMNS];
+
+  // Command being collected
+  uint8_t Cmd;
+  uint8_t Args[7];
+  uint8_t ArgsWanted;
+  uint8_t ArgsHave;
+
+  // Addressing
+  uint8_t Mode;  // 0 horizontal, 1 vertical, 2 page
+  uint8_t Page;
+  uint8_t Column;
+  uint8_t ColumnBase;  // column set by 00-1F, page mode wraps back to it
+  uint8_t ColumnStart, ColumnEnd;
+  uint8_t PageStart, PageEnd;
+  uint8_t RmwColumn;
+  uint8_t Rmw;
+
+  // Display
+  uint8_t DisplayOn;
+  uint8_t EntireOn;
+  uint8_t Invert;
+  uint8_t Contrast;
+  uint8_t StartLine;
+  uint8_t Offset;
+  uint8_t Multiplex;
+  uint8_t SegRemap;
+  uint8_t ComReverse;
+
+  // Scrolling (SSD1306)
+  uint8_t ScrollActive;
+  uint8_t ScrollLeft;
+  uint8_t ScrollPageStart, ScrollPageEnd;
+  uint8_t ScrollVertical;  // vertical offset per step, 0 for horizontal only
+  uint8_t VScroll;         // accumulated vertical offset
+  uint8_t AreaTop, AreaRows;
+
+  SSD1306_EmulatorStats Stats;
+};
+
+#endif  // SSD1306_EMULATOR_H
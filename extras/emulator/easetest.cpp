@@ -0,0 +1,51 @@
+// Sweeps SSD1306_Transition::ease() over every input for each easing and
+// checks that the eased progress starts at 0, ends at 65535 and
+// never decreases, so a transition never steps back towards the old screen.
+// The exit status is 1 on the first violation.
+//
+// Build:
+//   g++ -std=gnu++14 -O2 -I. -I../.. easetest.cpp SSD1306_Emulator.cpp ../../SSD1306_Transition.cpp ../../SSD1306.cpp ../../SSD1306_Fonts.cpp ../../SSD1306_Bitmap.cpp -o easetest
+
+#include <cstdio>
+#include "SSD1306_Transition.h"
+
+static const struct {
+  const char* name;
+  uint8_t easing;
+} easings[] = {
+  { "linear", EASE_LINEAR },
+  { "in-out", EASE_IN_OUT },
+  { "out", EASE_OUT },
+};
+
+int main() {
+  int failed = 0;
+
+  for (size_t e = 0; e < sizeof(easings) / sizeof(easings[0]); e++) {
+    uint16_t prev = SSD1306_Transition::ease(0, easings[e].easing);
+    uint16_t last = SSD1306_Transition::ease(0xFFFF, easings[e].easing);
+    long t;
+
+    if (prev != 0) {
+      printf("%s: ease(0) = %u\n", easings[e].name, (unsigned)prev);
+      failed++;
+    }
+    if (last != 0xFFFF) {
+      printf("%s: ease(65535) = %u\n", easings[e].name, (unsigned)last);
+      failed++;
+    }
+
+    for (t = 1; t <= 0xFFFF; t++) {
+      uint16_t v = SSD1306_Transition::ease((uint16_t)t, easings[e].easing);
+      if (v < prev) {
+        printf("%s: ease(%ld) = %u < ease(%ld) = %u\n", easings[e].name, t, (unsigned)v, t - 1, (unsigned)prev);
+        failed++;
+        break;
+      }
+      prev = v;
+    }
+    printf("%-8s %s\n", easings[e].name, (t > 0xFFFF) ? "ok" : "decreasing");
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+// Stress test of SSD1306_RenderQueue on the host, std::thread stands in for
+// the FreeRTOS tasks: several producers post batches while one consumer
+// thread runs process() and flushes to SSD1306_Emulator.
+//
+// Every batch paints its producer's column band in two halves, so a frame
+// flushed in the middle of a batch shows up as a band whose halves differ.
+// After every flush the panel is checked for that, and at the end every
+// posted batch must have been applied exactly once. The exit status is 1 on
+// a torn frame or a lost batch.
+//
+// Build:
+//   g++ -std=gnu++14 -O2 -pthread -I. -I../.. queuetest.cpp SSD1306_Emulator.cpp ../../SSD1306.cpp ../../SSD1306_Fonts.cpp ../../SSD1306_Bitmap.cpp ../../SSD1306_RenderQueue.cpp -o queuetest
+//
+// Usage:
+//   queuetest [batches per producer]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "SSD1306.h"
+#include "SSD1306_Emulator.h"
+#include "SSD1306_RenderQueue.h"
+
+enum { PIN_MOSI = 23, PIN_CLK = 18, PIN_DC = 16, PIN_RST = 17, PIN_CS = 5 };
+
+static const int PRODUCERS = 4;
+static const int16_t BAND = SSD1306_WIDTH / PRODUCERS;
+
+static void produce(SSD1306_RenderQueue& queue, int id, uint32_t batches, std::atomic<uint32_t>& posted) {
+  int16_t x = id * BAND;
+
+  for (uint32_t i = 0; i < batches; i++) {
+    SSD1306_COLOR color = (i & 1) ? SSD1306_WHITE : SSD1306_BLACK;
+    SSD1306_DrawBatch batch;
+
+    batch.fillRect(x, 0, BAND, SSD1306_HEIGHT / 2, color);
+    batch.fillRect(x, SSD1306_HEIGHT / 2, BAND, SSD1306_HEIGHT / 2, color);
+
+    // A full queue is not an error for the producer, try again later
+    while (!queue.post(batch)) std::this_thread::yield();
+    posted++;
+  }
+}
+
+// Number of bands whose top and bottom halves show different batches
+static int tornBands(const SSD1306_Emulator& panel) {
+  int torn = 0;
+
+  for (int p = 0; p < PRODUCERS; p++) {
+    uint8_t top = panel.pixel(p * BAND, 0);
+    uint8_t bottom = panel.pixel(p * BAND, SSD1306_HEIGHT - 1);
+    if (top != bottom) torn++;
+  }
+  return torn;
+}
+
+int main(int argc, char** argv) {
+  uint32_t batches = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000;
+
+  SSD1306_Emulator panel(PIN_DC, PIN_CS, PIN_RST);
+  SSD1306 oled(PIN_MOSI, PIN_CLK, PIN_DC, PIN_RST, PIN_CS);
+  SSD1306_RenderQueue queue;
+  std::atomic<uint32_t> posted(0);
+  std::atomic<int> running(PRODUCERS);
+  uint32_t applied = 0;
+  uint32_t flushes = 0;
+  uint32_t torn = 0;
+
+  panel.attach();
+  oled.init();
+
+  // Only the consumer touches the framebuffer and the bus
+  std::thread consumer([&]() {
+    for (;;) {
+      bool last = running.load() == 0;
+      uint16_t n = queue.process(oled);
+
+      if (n) {
+        applied += n;
+        flushes++;
+        if (tornBands(panel)) torn++;
+      } else if (last) {
+        break;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; p++) {
+    producers.push_back(std::thread([&, p]() {
+      produce(queue, p, batches, posted);
+      running--;
+    }));
+  }
+
+  for (size_t p = 0; p < producers.size(); p++) producers[p].join();
+  consumer.join();
+
+  printf("%u batches posted, %u applied in %u flushes, %u full-queue retries, %u torn frames\n", (unsigned)posted.load(),
+         (unsigned)applied, (unsigned)flushes, (unsigned)queue.dropped(), (unsigned)torn);
+
+  return (torn || applied != posted.load() || posted.load() != batches * PRODUCERS) ? 1 : 0;
+}
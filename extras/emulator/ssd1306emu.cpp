@@ -0,0 +1,213 @@
+// Runs the unchanged SSD1306 driver on the host against SSD1306_Emulator.
+//
+// Draws a fixed set of frames (all rotations, dirty flushes, incremental
+// flushes, text, patterns), checks after each flush that the emulated panel
+// shows exactly what the framebuffer holds, and that the flush took the bus
+// traffic listed in `frames` below. With -o the panel images are written as
+// PBM, with -g they are compared against golden images from an earlier run.
+// The exit status is 1 if any frame or count does not match, so it can gate
+// changes to the flush path:
+//
+//   ssd1306emu -o golden          # once, review the images
+//   ssd1306emu -g golden          # after a change
+//
+// Build:
+//   g++ -std=gnu++14 -O2 -I. -I../.. ssd1306emu.cpp SSD1306_Emulator.cpp ../../SSD1306.cpp ../../SSD1306_Fonts.cpp ../../SSD1306_Bitmap.cpp -o ssd1306emu
+//
+// Usage:
+//   ssd1306emu [-c sh1106|ssd1306] [-o dir] [-g dir]
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "SSD1306.h"
+#include "SSD1306_Emulator.h"
+
+enum { PIN_MOSI = 23, PIN_CLK = 18, PIN_DC = 16, PIN_RST = 17, PIN_CS = 5 };
+
+enum Flush {
+  FLUSH_NONE,  // init() already flushed
+  FLUSH_FULL,
+  FLUSH_DIRTY,
+  FLUSH_PAGES
+};
+
+typedef struct {
+  const char* name;
+  Flush flush;
+  void (*draw)(SSD1306& oled);
+  // Expected bus traffic of the flush, see SSD1306_EmulatorStats
+  uint32_t commands;
+  uint32_t commandBytes;
+  uint32_t dataBytes;
+  uint32_t transactions;
+} Frame;
+
+static void drawInit(SSD1306& oled) {
+  (void)oled;
+}
+
+static void drawShapes(SSD1306& oled) {
+  oled.setRotation(0);
+  oled.clear();
+  oled.drawRect(0, 0, 128, 64);
+  oled.fillCircle(100, 32, 20, SSD1306_WHITE, SSD1306_PATTERN_CHECKER);
+  oled.drawTriangle(10, 60, 40, 10, 70, 60, SSD1306_WHITE);
+  oled.drawLine(2, 2, 125, 61, SSD1306_INVERSE, SSD1306_LINE_DASHED);
+  oled.setCursor(4, 4);
+  oled.writeString("Emulated", Font_7x10, SSD1306_WHITE);
+}
+
+static void drawDirty(SSD1306& oled) {
+  oled.fillRect(20, 20, 30, 12, SSD1306_INVERSE);
+  oled.markDirty(20, 20, 30, 12);
+}
+
+static void drawFlood(SSD1306& oled) {
+  static uint8_t scratch[SSD1306_BUFFER_SIZE];
+
+  oled.clear();
+  oled.drawCircle(64, 32, 28, SSD1306_WHITE);
+  oled.drawRoundRect(44, 20, 40, 24, 6, SSD1306_WHITE);
+  oled.floodFill(64, 8, SSD1306_WHITE, scratch, SSD1306_PATTERN_HATCH_DOWN);
+  oled.floodFill(64, 32, SSD1306_WHITE, scratch);
+}
+
+static void drawRotated(SSD1306& oled, uint16_t degrees) {
+  oled.setRotation(degrees);
+  oled.clear();
+  oled.drawRect(0, 0, oled.width(), oled.height());
+  oled.drawLine(0, 0, 20, 40, SSD1306_WHITE);
+  oled.setCursor(3, 3);
+  oled.setTextStyle(TEXT_BOLD, 2);
+  oled.writeString("R", Font_7x10, SSD1306_WHITE);
+  oled.setTextStyle(TEXT_OPAQUE);
+}
+
+static void drawRot90(SSD1306& oled) { drawRotated(oled, 90); }
+static void drawRot180(SSD1306& oled) { drawRotated(oled, 180); }
+static void drawRot270(SSD1306& oled) { drawRotated(oled, 270); }
+
+static void drawPages(SSD1306& oled) {
+  oled.setRotation(0);
+  oled.clear(SSD1306_WHITE);
+  oled.fillRect(8, 8, 112, 48, SSD1306_BLACK, SSD1306_PATTERN_GRID);
+}
+
+// A full frame is 8 pages of 3 addressing commands and 128 data bytes, the
+// dirty rectangle spans 2 pages of 30 columns
+static const Frame frames[] = {
+  { "init", FLUSH_NONE, drawInit, 40, 48, 1024, 56 },
+  { "shapes", FLUSH_FULL, drawShapes, 24, 24, 1024, 32 },
+  { "dirty", FLUSH_DIRTY, drawDirty, 6, 6, 60, 8 },
+  { "flood", FLUSH_FULL, drawFlood, 24, 24, 1024, 32 },
+  { "rot90", FLUSH_FULL, drawRot90, 24, 24, 1024, 32 },
+  { "rot180", FLUSH_FULL, drawRot180, 24, 24, 1024, 32 },
+  { "rot270", FLUSH_FULL, drawRot270, 24, 24, 1024, 32 },
+  { "pages", FLUSH_PAGES, drawPages, 24, 24, 1024, 32 },
+};
+
+// Panel pixel that logical pixel (x, y) of the framebuffer must light, see
+// SSD1306::transposePage() and setRotation()
+static void toPanel(uint8_t rotation, int16_t x, int16_t y, int16_t* px, int16_t* py) {
+  switch (rotation) {
+    case 0: *px = x; *py = y; break;
+    case 1: *px = y; *py = SSD1306_HEIGHT - 1 - x; break;
+    case 2: *px = SSD1306_WIDTH - 1 - x; *py = SSD1306_HEIGHT - 1 - y; break;
+    default: *px = SSD1306_WIDTH - 1 - y; *py = x; break;
+  }
+}
+
+static long compareBuffer(SSD1306& oled, const SSD1306_Emulator& panel) {
+  const uint8_t* buf = oled.getBuffer();
+  long diff = 0;
+
+  for (int16_t y = 0; y < oled.height(); y++) {
+    for (int16_t x = 0; x < oled.width(); x++) {
+      int16_t px, py;
+      toPanel(oled.getRotation(), x, y, &px, &py);
+      uint8_t bit = (buf[x + (y / 8) * oled.width()] >> (y & 7)) & 1;
+      if (bit != panel.pixel(px, py)) diff++;
+    }
+  }
+  return diff;
+}
+
+int main(int argc, char** argv) {
+  SSD1306_Emulator::Controller type = SSD1306_Emulator::CONTROLLER_SH1106;
+  const char* outDir = NULL;
+  const char* goldenDir = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "c:o:g:")) != -1) {
+    switch (opt) {
+      case 'c':
+        if (!strcmp(optarg, "ssd1306")) type = SSD1306_Emulator::CONTROLLER_SSD1306;
+        else if (strcmp(optarg, "sh1106")) goto usage;
+        break;
+      case 'o': outDir = optarg; break;
+      case 'g': goldenDir = optarg; break;
+      default: goto usage;
+    }
+  }
+
+  {
+    SSD1306_Emulator panel(PIN_DC, PIN_CS, PIN_RST, type);
+    SSD1306 oled(PIN_MOSI, PIN_CLK, PIN_DC, PIN_RST, PIN_CS);
+    int failed = 0;
+
+    panel.attach();
+    printf("%-8s %8s %8s %8s %8s %8s  %s\n", "frame", "commands", "cmdbytes", "data", "cs", "us", "result");
+
+    for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); i++) {
+      const Frame& f = frames[i];
+
+      f.draw(oled);
+      panel.resetStats();
+      unsigned long start = micros();
+
+      switch (f.flush) {
+        case FLUSH_NONE: oled.init(); break;
+        case FLUSH_FULL: oled.display(); break;
+        case FLUSH_DIRTY: oled.displayDirty(); break;
+        case FLUSH_PAGES:
+          while (!oled.flushPages(3)) {}
+          break;
+      }
+
+      unsigned long us = micros() - start;
+      const SSD1306_EmulatorStats& s = panel.stats();
+      long diff = compareBuffer(oled, panel);
+      char path[256];
+      char result[64];
+
+      snprintf(result, sizeof(result), diff ? "%ld pixels differ from buffer" : "ok", diff);
+      if (!diff && (s.commands != f.commands || s.commandBytes != f.commandBytes || s.dataBytes != f.dataBytes ||
+                    s.transactions != f.transactions)) {
+        snprintf(result, sizeof(result), "expected %u %u %u %u", (unsigned)f.commands, (unsigned)f.commandBytes,
+                 (unsigned)f.dataBytes, (unsigned)f.transactions);
+        diff = 1;
+      }
+      if (goldenDir && !diff) {
+        snprintf(path, sizeof(path), "%s/%s.pbm", goldenDir, f.name);
+        long g = panel.diffPBM(path);
+        if (g < 0) snprintf(result, sizeof(result), "no golden image");
+        else if (g > 0) snprintf(result, sizeof(result), "%ld pixels differ from golden", g);
+        diff = g ? 1 : 0;
+      }
+      if (outDir) {
+        snprintf(path, sizeof(path), "%s/%s.pbm", outDir, f.name);
+        if (!panel.writePBM(path)) perror(path);
+      }
+
+      printf("%-8s %8u %8u %8u %8u %8lu  %s\n", f.name, (unsigned)s.commands, (unsigned)s.commandBytes,
+             (unsigned)s.dataBytes, (unsigned)s.transactions, us, result);
+      if (diff) failed++;
+    }
+    return failed ? 1 : 0;
+  }
+
+usage:
+  fprintf(stderr, "usage: %s [-c sh1106|ssd1306] [-o dir] [-g dir]\n", argv[0]);
+  return 2;
+}
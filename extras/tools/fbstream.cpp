@@ -0,0 +1,212 @@
+// Host-side encoder for the SSD1306 remote framebuffer stream (SSD1306_Stream.h).
+//
+// Sends a sequence of frames (PBM images or raw page-format dumps) to a device
+// running SSD1306_Remote, each delta-encoded against the previous frame, and
+// prints the encoded size and the frame rate the link allows. Every 30th frame
+// is a keyframe by default (-k), so the device recovers from a corrupted frame
+// without a restart; -k 0 sends only the first one. With -d it
+// decodes a stream back into PBM files, e.g. as the far end of a pty pair for
+// testing without hardware:
+//
+//   socat -d -d pty,raw,echo=0 pty,raw,echo=0     # prints two /dev/pts/N
+//   fbstream -d /dev/pts/3 out &                   # writes out0000.pbm, ...
+//   fbstream -b 921600 /dev/pts/2 frame*.pbm
+//
+// Build:
+//   g++ -O2 -I../.. fbstream.cpp ../../SSD1306_Stream.cpp ../../SSD1306_Bitmap.cpp -o fbstream
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+#include "SSD1306_Bitmap.h"
+#include "SSD1306_Stream.h"
+
+static const uint8_t W = 128;
+static const uint8_t PAGES = 8;
+
+static speed_t toSpeed(long baud) {
+  switch (baud) {
+    case 9600: return B9600;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    case 2000000: return B2000000;
+    default: return B0;
+  }
+}
+
+static int openLink(const char* path, long baud, bool input) {
+  if (!strcmp(path, "-")) return input ? 0 : 1;
+
+  int fd = open(path, (input ? O_RDONLY : O_WRONLY) | O_NOCTTY);
+  if (fd < 0) {
+    perror(path);
+    return -1;
+  }
+
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    if (toSpeed(baud) != B0) cfsetspeed(&tio, toSpeed(baud));
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+static int readToken(FILE* f) {
+  int c;
+  for (;;) {
+    c = fgetc(f);
+    if (c == '#') {
+      while (c != '\n' && c != EOF) c = fgetc(f);
+    } else if (!isspace(c)) {
+      break;
+    }
+  }
+  if (c == EOF || !isdigit(c)) return -1;
+
+  int v = 0;
+  while (c != EOF && isdigit(c)) {
+    v = v * 10 + (c - '0');
+    c = fgetc(f);
+  }
+  return v;
+}
+
+// Load a 128x64 frame from a P4 PBM or a raw 1024 byte page-format dump
+static bool loadFrame(const char* path, uint8_t* pages) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+
+  bool ok = false;
+  char magic[2];
+  if (fread(magic, 1, 2, f) == 2 && magic[0] == 'P' && magic[1] == '4') {
+    if (readToken(f) == W && readToken(f) == PAGES * 8) {
+      std::vector<uint8_t> img(ssd1306_rowmajor_size(W, PAGES * 8));
+      ok = fread(img.data(), 1, img.size(), f) == img.size();
+      if (ok) ssd1306_rowmajor_to_pages(img.data(), W, PAGES * 8, pages);
+    }
+  } else {
+    rewind(f);
+    ok = fread(pages, 1, W * PAGES, f) == (size_t)W * PAGES;
+  }
+
+  fclose(f);
+  if (!ok) fprintf(stderr, "%s: not a 128x64 P4 PBM or raw frame\n", path);
+  return ok;
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t n) {
+  while (n) {
+    ssize_t r = write(fd, data, n);
+    if (r <= 0) return false;
+    data += r;
+    n -= r;
+  }
+  return true;
+}
+
+static int encode(long baud, int keyInterval, const char* link, char** files, int count) {
+  int fd = openLink(link, baud, false);
+  if (fd < 0) return 1;
+
+  uint8_t prev[W * PAGES], cur[W * PAGES];
+  std::vector<uint8_t> out(SSD1306_STREAM_MAX(W, PAGES));
+  size_t total = 0;
+
+  for (int i = 0; i < count; i++) {
+    if (!loadFrame(files[i], cur)) return 1;
+
+    bool key = i == 0 || (keyInterval && i % keyInterval == 0);
+    size_t n = ssd1306_stream_encode(key ? NULL : prev, cur, W, PAGES, out.data(), (uint8_t)i);
+    if (!writeAll(fd, out.data(), n)) {
+      perror(link);
+      return 1;
+    }
+
+    fprintf(stderr, "%s: %u bytes%s\n", files[i], (unsigned)n, key ? " (key)" : "");
+    memcpy(prev, cur, sizeof(prev));
+    total += n;
+  }
+
+  // 10 bits per byte on a UART
+  double avg = (double)total / count;
+  fprintf(stderr, "%d frames, %.1f bytes/frame, %.1f frames/s at %ld baud\n", count, avg, baud / 10.0 / avg, baud);
+  return 0;
+}
+
+static int decode(long baud, const char* link, const char* prefix) {
+  int fd = openLink(link, baud, true);
+  if (fd < 0) return 1;
+
+  uint8_t pages[W * PAGES];
+  memset(pages, 0, sizeof(pages));
+
+  SSD1306_StreamDecoder decoder;
+  decoder.begin(pages, W, PAGES);
+
+  uint8_t buf[256];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) {
+    for (ssize_t i = 0; i < n; i++) {
+      int8_t r = decoder.feed(buf[i]);
+      if (r == SSD1306_StreamDecoder::ERROR) {
+        fprintf(stderr, "bad frame\n");
+      } else if (r == SSD1306_StreamDecoder::DROPPED) {
+        fprintf(stderr, "delta dropped, waiting for a keyframe\n");
+      } else if (r == SSD1306_StreamDecoder::FRAME) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s%04u.pbm", prefix, (unsigned)decoder.frames() - 1);
+
+        std::vector<uint8_t> img(ssd1306_rowmajor_size(W, PAGES * 8));
+        ssd1306_pages_to_rowmajor(pages, W, PAGES * 8, img.data());
+
+        FILE* f = fopen(path, "wb");
+        if (!f) {
+          perror(path);
+          return 1;
+        }
+        fprintf(f, "P4\n%u %u\n", W, PAGES * 8);
+        fwrite(img.data(), 1, img.size(), f);
+        fclose(f);
+      }
+    }
+  }
+
+  fprintf(stderr, "%u frames, %u errors, %u dropped\n", (unsigned)decoder.frames(), (unsigned)decoder.errors(),
+          (unsigned)decoder.dropped());
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  long baud = 115200;
+  int keyInterval = 30;
+  bool decodeMode = false;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:k:d")) != -1) {
+    switch (opt) {
+      case 'b': baud = atol(optarg); break;
+      case 'k': keyInterval = atoi(optarg); break;
+      case 'd': decodeMode = true; break;
+      default: optind = argc + 1; break;
+    }
+  }
+
+  if (decodeMode && argc - optind == 2) return decode(baud, argv[optind], argv[optind + 1]);
+  if (!decodeMode && argc - optind >= 2) return encode(baud, keyInterval, argv[optind], &argv[optind + 1], argc - optind - 1);
+
+  fprintf(stderr, "usage: %s [-b baud] [-k keyframe_interval] device|- frame.pbm|frame.bin ...\n", argv[0]);
+  fprintf(stderr, "       %s -d [-b baud] device|- out_prefix\n", argv[0]);
+  return 2;
+}
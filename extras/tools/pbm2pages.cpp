@@ -0,0 +1,139 @@
+// Host-side asset converter for SSD1306 page-format bitmaps.
+//
+// Converts a PBM image (P1 or P4, black pixels are drawn) into a C array in
+// the page format used by SSD1306::drawBitmap(), using the same SWAR transpose
+// kernel as the library. With -r it converts a raw page-format dump (for
+// example a framebuffer snapshot written over serial) back into a P4 PBM.
+//
+// Build:
+//   g++ -O2 -I../.. pbm2pages.cpp ../../SSD1306_Bitmap.cpp -o pbm2pages
+//
+// Usage:
+//   pbm2pages logo.pbm logo > logo.h
+//   pbm2pages -r 128 64 frame.bin > frame.pbm
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "SSD1306_Bitmap.h"
+
+static int readToken(FILE* f) {
+  int c;
+
+  // Skip whitespace and comments
+  for (;;) {
+    c = fgetc(f);
+    if (c == '#') {
+      while (c != '\n' && c != EOF) c = fgetc(f);
+    } else if (!isspace(c)) {
+      break;
+    }
+  }
+  if (c == EOF || !isdigit(c)) return -1;
+
+  int v = 0;
+  while (c != EOF && isdigit(c)) {
+    v = v * 10 + (c - '0');
+    c = fgetc(f);
+  }
+  return v;
+}
+
+static bool readPBM(FILE* f, uint16_t* w, uint16_t* h, std::vector<uint8_t>& img) {
+  char magic[2];
+  if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || (magic[1] != '1' && magic[1] != '4')) return false;
+
+  int iw = readToken(f);
+  int ih = readToken(f);
+  if (iw <= 0 || ih <= 0 || iw > 0xFFFF || ih > 0xFFFF) return false;
+
+  *w = (uint16_t)iw;
+  *h = (uint16_t)ih;
+  img.assign(ssd1306_rowmajor_size(*w, *h), 0);
+
+  if (magic[1] == '4') {
+    // Binary PBM is already row-major, MSB first
+    return fread(img.data(), 1, img.size(), f) == img.size();
+  }
+
+  uint16_t bw = (*w + 7) >> 3;
+  for (uint16_t y = 0; y < *h; y++) {
+    for (uint16_t x = 0; x < *w; x++) {
+      int c;
+      do c = fgetc(f);
+      while (c != EOF && c != '0' && c != '1');
+      if (c == EOF) return false;
+      if (c == '1') img[y * bw + (x >> 3)] |= 0x80 >> (x & 7);
+    }
+  }
+  return true;
+}
+
+static int toHeader(const char* path, const char* name) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+
+  uint16_t w, h;
+  std::vector<uint8_t> img;
+  bool ok = readPBM(f, &w, &h, img);
+  fclose(f);
+  if (!ok) {
+    fprintf(stderr, "%s: not a valid PBM image\n", path);
+    return 1;
+  }
+
+  std::vector<uint8_t> pages(ssd1306_pages_size(w, h));
+  ssd1306_rowmajor_to_pages(img.data(), w, h, pages.data());
+
+  printf("// Generated by pbm2pages from %s\n", path);
+  printf("#define %s_width %u\n", name, w);
+  printf("#define %s_height %u\n", name, h);
+  printf("const uint8_t %s[] = {", name);
+  for (size_t i = 0; i < pages.size(); i++) {
+    if (i % 16 == 0) printf("\n ");
+    printf(" 0x%02X,", pages[i]);
+  }
+  printf("\n};\n");
+  return 0;
+}
+
+static int toPBM(uint16_t w, uint16_t h, const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+
+  std::vector<uint8_t> pages(ssd1306_pages_size(w, h));
+  size_t n = fread(pages.data(), 1, pages.size(), f);
+  fclose(f);
+  if (n != pages.size()) {
+    fprintf(stderr, "%s: expected %u bytes, got %u\n", path, (unsigned)pages.size(), (unsigned)n);
+    return 1;
+  }
+
+  std::vector<uint8_t> img(ssd1306_rowmajor_size(w, h));
+  ssd1306_pages_to_rowmajor(pages.data(), w, h, img.data());
+
+  printf("P4\n%u %u\n", w, h);
+  fwrite(img.data(), 1, img.size(), stdout);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc == 5 && !strcmp(argv[1], "-r")) {
+    return toPBM((uint16_t)atoi(argv[2]), (uint16_t)atoi(argv[3]), argv[4]);
+  }
+  if (argc == 3) {
+    return toHeader(argv[1], argv[2]);
+  }
+
+  fprintf(stderr, "usage: %s image.pbm name > name.h\n", argv[0]);
+  fprintf(stderr, "       %s -r width height pages.bin > image.pbm\n", argv[0]);
+  return 2;
+}